@@ -0,0 +1,92 @@
+///
+/// @file   PiTable.cpp
+/// @brief  Benchmark the construction of the PiTable for
+///         x = 10^9, 10^10, ..., max_x using both the default
+///         and the compact PiTable layout. The throughput is
+///         reported in GB/s of PiTable memory written.
+///
+///         Usage: benchmark_PiTable [max_x] [threads]
+///         The default max_x = 1e10 requires 667 MB of memory.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <PiTable.hpp>
+#include <primecount.hpp>
+#include <primecount-internal.hpp>
+#include <int128_t.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace primecount;
+
+namespace {
+
+void benchmark(uint64_t max_x,
+               int exponent,
+               int threads,
+               bool is_compact)
+{
+  double time = get_time();
+  PiTable pi(max_x, threads, is_compact);
+  time = get_time() - time;
+
+  double gb = PiTable_bytes(max_x, is_compact) / 1e9;
+  uint64_t pix = pi[max_x];
+
+  std::cout << std::left
+            << std::setw(8) << ("1e" + std::to_string(exponent))
+            << std::setw(10) << (is_compact ? "compact" : "default")
+            << std::setw(10) << std::fixed << std::setprecision(3) << gb
+            << std::setw(10) << time
+            << std::setw(10) << gb / time
+            << pix << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    maxint_t max_x = (int64_t) 1e10;
+    int threads = get_num_threads();
+
+    if (argc > 1)
+      max_x = to_maxint(argv[1]);
+    if (argc > 2)
+      threads = std::atoi(argv[2]);
+
+    std::cout << "PiTable construction, threads = " << threads << std::endl;
+    std::cout << std::left
+              << std::setw(8) << "x"
+              << std::setw(10) << "layout"
+              << std::setw(10) << "GB"
+              << std::setw(10) << "seconds"
+              << std::setw(10) << "GB/s"
+              << "pi(x)" << std::endl;
+
+    uint64_t x = (uint64_t) 1e9;
+
+    for (int i = 9; x <= max_x && i < 20; i++, x *= 10)
+    {
+      benchmark(x, i, threads, false);
+      benchmark(x, i, threads, true);
+    }
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+///
+/// @file   pi_cost.cpp
+/// @brief  Measure the constant of the pi_cost(x) model used
+///         by pi(low, high), nth_prime(n) and pi_anchor(x)
+///         (see src/sieve_cost.cpp). For x = 10^9, 10^10, ...,
+///         max_x this benchmark measures the time of
+///         pi_gourdon(x) and the throughput of the segmented
+///         sieve of Eratosthenes near x. Their product is the
+///         number of sieved numbers that is as expensive as a
+///         single pi(x) computation.
+///
+///         Usage: benchmark_pi_cost [max_x] [threads]
+///         The default max_x = 1e16 takes about 15 seconds.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <gourdon.hpp>
+#include <primecount.hpp>
+#include <primecount-internal.hpp>
+#include <primesieve.hpp>
+#include <int128_t.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace primecount;
+
+namespace {
+
+void benchmark(int64_t x, int exponent, int threads)
+{
+  double pi_secs = get_time();
+  pi_gourdon_64(x, threads, false);
+  pi_secs = get_time() - pi_secs;
+
+  // Sieving 10^9 numbers near x
+  uint64_t dist = (uint64_t) 1e9;
+  double sieve_secs = get_time();
+  primesieve::count_primes(x, x + dist);
+  sieve_secs = get_time() - sieve_secs;
+
+  double rate = dist / sieve_secs;
+  double measured = pi_secs * rate;
+  double model = pi_cost(x);
+
+  std::cout << std::left
+            << std::setw(8) << ("1e" + std::to_string(exponent))
+            << std::setw(12) << std::fixed << std::setprecision(3) << pi_secs
+            << std::setw(12) << std::scientific << std::setprecision(2) << rate
+            << std::setw(12) << measured
+            << std::setw(12) << model
+            << std::fixed << std::setprecision(2) << measured / model
+            << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    maxint_t max_x = (int64_t) 1e16;
+    int threads = 1;
+
+    if (argc > 1)
+      max_x = to_maxint(argv[1]);
+    if (argc > 2)
+      threads = std::atoi(argv[2]);
+
+    primesieve::set_num_threads(threads);
+
+    std::cout << "pi(x) cost in sieved numbers, threads = " << threads << std::endl;
+    std::cout << std::left
+              << std::setw(8) << "x"
+              << std::setw(12) << "pi(x) secs"
+              << std::setw(12) << "sieve/s"
+              << std::setw(12) << "measured"
+              << std::setw(12) << "pi_cost(x)"
+              << "ratio" << std::endl;
+
+    int64_t x = (int64_t) 1e9;
+
+    for (int i = 9; x <= max_x && i < 19; i++, x *= 10)
+      benchmark(x, i, threads);
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,114 @@
+///
+/// @file  AsyncContext.hpp
+/// @brief The AsyncContext class is shared between an asynchronous
+///        computation started using pi_async() (or
+///        nth_prime_async()) and its handle. The load balancers
+///        (LoadBalancerS2, LoadBalancerAC and LoadBalancerP2)
+///        check is_cancelled() whenever a thread requests new
+///        work, hence a cancelled computation stops within a few
+///        milliseconds. pi_gourdon() and pi_deleglise_rivat()
+///        additionally call check_cancelled() between their
+///        formulas, hence the formulas that have not been started
+///        yet (and their lookup tables) are skipped. The load
+///        balancers also report their progress (in percent) to
+///        the AsyncContext.
+///
+///        The AsyncContext of the current computation is stored in
+///        a thread_local variable of the thread that starts the
+///        computation. The load balancers are created by that
+///        thread (outside of the OpenMP parallel regions) and store
+///        a pointer to the AsyncContext. Nested computations
+///        (pi_noprint(), e.g. pi(x / prime) in B(x, y)) run
+///        without AsyncContext: they may run inside of an OpenMP
+///        parallel region which must not throw an exception, and
+///        their progress is not the progress of the current
+///        formula.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef ASYNCCONTEXT_HPP
+#define ASYNCCONTEXT_HPP
+
+#include <atomic>
+#include <functional>
+
+namespace primecount {
+
+class AsyncContext
+{
+public:
+  bool is_cancelled() const
+  {
+    return cancelled_.load(std::memory_order_relaxed);
+  }
+
+  void cancel()
+  {
+    cancelled_.store(true, std::memory_order_relaxed);
+  }
+
+  double percent() const
+  {
+    return percent_.load(std::memory_order_relaxed);
+  }
+
+  void set_callback(const std::function<void(double)>& callback)
+  {
+    callback_ = callback;
+  }
+
+  /// Called by the load balancers inside of their
+  /// critical section (LoadBalancerAC: by at most one
+  /// thread at a time), hence it is never called
+  /// simultaneously from multiple threads.
+  ///
+  void progress(double percent);
+
+private:
+  std::atomic<bool> cancelled_{false};
+  std::atomic<double> percent_{0};
+  std::function<void(double)> callback_;
+  double time_ = 0;
+};
+
+/// Returns the AsyncContext of the computation
+/// running in the calling thread (or nullptr).
+///
+AsyncContext* get_async_context();
+void set_async_context(AsyncContext* context);
+
+/// Throws a primecount_error if the computation
+/// running in the calling thread has been cancelled.
+/// Must not be called inside of a parallel region.
+///
+void check_cancelled();
+
+/// Install an AsyncContext (or nullptr) for the
+/// calling thread, the previous AsyncContext is
+/// restored when going out of scope.
+///
+class AsyncContextGuard
+{
+public:
+  AsyncContextGuard(AsyncContext* context)
+    : previous_(get_async_context())
+  {
+    set_async_context(context);
+  }
+  ~AsyncContextGuard()
+  {
+    set_async_context(previous_);
+  }
+  AsyncContextGuard(const AsyncContextGuard&) = delete;
+  AsyncContextGuard& operator=(const AsyncContextGuard&) = delete;
+private:
+  AsyncContext* previous_;
+};
+
+} // namespace
+
+#endif
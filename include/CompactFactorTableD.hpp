@@ -0,0 +1,317 @@
+///
+/// @file  CompactFactorTableD.hpp
+/// @brief The CompactFactorTableD class is a bit-packed variant of
+///        the FactorTableD class (see FactorTableD.hpp) which is
+///        used for large values of z. FactorTableD<uint32_t> stores
+///        a 32-bit value (the least prime factor combined with the
+///        Möbius function value) for each number that is not
+///        divisible by 2, 3, 5, 7 and 11. CompactFactorTableD
+///        instead stores the index of the least prime factor in the
+///        primes array (i.e. pi[lpf]) using the minimal number of
+///        bits. For square free numbers n <= z with mu(n) != 0 and
+///        mpf(n) <= y we have lpf(n) <= sqrt(z), hence each entry
+///        requires only about log2(2 * pi(sqrt(z))) bits.
+///        E.g. for z = 10^12 each entry uses 18 bits instead of 32
+///        bits and for z = 10^14 each entry uses 21 bits.
+///
+///        What we store in the factor[n] lookup table:
+///
+///        1) MAX - 1            if n = 1
+///        2) MAX                if n is a prime
+///        3) 0                  if n has a prime factor > y
+///        4) 0                  if moebius(n) = 0
+///        5) 2 * pi[lpf]        if moebius(n) = 1
+///        6) 2 * pi[lpf] + 1    if moebius(n) = -1
+///
+///        With MAX = 2^bits - 1. Note that in the D(x, y) formula
+///        the prime index b is known, hence the old if statement
+///        below can be replaced by the 2nd new if statement:
+///
+///        * Old: if (mu[n] != 0 && lpf[n] > prime && mpf[n] <= y)
+///        * New: if (2 * b + 1 < factor[n])
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef COMPACTFACTORTABLED_HPP
+#define COMPACTFACTORTABLED_HPP
+
+#include <primecount.hpp>
+#include <primecount-internal.hpp>
+#include <BaseFactorTable.hpp>
+#include <primesieve.hpp>
+#include <imath.hpp>
+#include <int128_t.hpp>
+#include <macros.hpp>
+#include <Numa.hpp>
+#include <Vector.hpp>
+
+#include <algorithm>
+#include <stdint.h>
+
+namespace {
+
+using namespace primecount;
+
+class CompactFactorTableD : public BaseFactorTable
+{
+public:
+  /// Factor numbers <= z
+  CompactFactorTableD(int64_t y,
+                      int64_t z,
+                      int threads)
+  {
+    if_unlikely(z > max())
+      throw primecount_error("z must be <= CompactFactorTableD::max()");
+
+    z = std::max<int64_t>(1, z);
+    int64_t sqrtz = isqrt(z);
+
+    // The largest value we need to store is MAX = 2^bits - 1
+    // which must be > 2 * pi(sqrt(z)) + 2 (the value of n = 1).
+    uint64_t max_leaf = 2 * primesieve::count_primes(0, sqrtz) + 2;
+    bits_ = ilog2(max_leaf) + 1;
+    bits_ = std::max(bits_, 2);
+    max_ = (uint64_t(1) << bits_) - 1;
+
+    // The last (padding) word is only
+    // accessed by the branchfree get().
+    int64_t size = to_index(z) + 1;
+    int64_t words = ceil_div(size * bits_, 64) + 1;
+    words_.resize(words);
+    numa_place(words_.data(), words_.size() * sizeof(uint64_t));
+    words_[words - 1] = 0;
+
+    // mu(1) = 1.
+    // 1 has zero prime factors, hence 1 has an even
+    // number of prime factors. We use the least
+    // significant bit to indicate whether the number
+    // has an even or odd number of prime factors.
+    words_[0] = 0;
+    set(0, max_ ^ 1);
+
+    int64_t thread_threshold = (int64_t) 1e7;
+    threads = ideal_num_threads(z, threads, thread_threshold);
+    int64_t thread_distance = ceil_div(z, threads);
+
+    // Each thread must process a distinct set of 64-bit
+    // words of the words_ array, since 2310 numbers are
+    // mapped to 480 entries we align the thread_distance
+    // to a multiple of 2 * 2310, which corresponds to
+    // 960 * bits = 15 * 64 * bits bits.
+    int64_t align = 2 * coprime_indexes_.size();
+    thread_distance += align - thread_distance % align;
+
+    #pragma omp parallel for num_threads(threads)
+    for (int t = 0; t < threads; t++)
+    {
+      // Thread processes interval [low, high]
+      int64_t low = thread_distance * t;
+      int64_t high = low + thread_distance;
+      low = std::max(first_coprime(), low + 1);
+      high = std::min(high, z);
+
+      if (low <= high)
+      {
+        // Default initialize memory to all bits set
+        int64_t low_idx = to_index(low);
+        int64_t high_idx = to_index(high);
+        for (int64_t i = low_idx; i <= high_idx; i++)
+          set(i, max_);
+
+        // Index of 13 in the primes array, primes[6] = 13
+        int64_t b = 6;
+        int64_t start = first_coprime();
+        int64_t stop = high / first_coprime();
+        int64_t min_m = first_coprime() * first_coprime();
+        primesieve::iterator it(start, stop);
+
+        if (min_m <= high)
+        {
+          for (;; b++)
+          {
+            // Find multiples > prime
+            int64_t i = 1;
+            int64_t prime = it.next_prime();
+            int64_t multiple = next_multiple(prime, low, &i);
+            min_m = prime * first_coprime();
+
+            if (min_m > high)
+              break;
+
+            for (; multiple <= high; multiple = prime * to_number(i++))
+            {
+              int64_t mi = to_index(multiple);
+              uint64_t factor = get(mi);
+              // prime is the smallest factor of multiple,
+              // multiple has 1 prime factor (odd).
+              if (factor == max_)
+              {
+                ASSERT(prime <= sqrtz);
+                set(mi, 2 * b + 1);
+              }
+              // the least significant bit indicates
+              // whether multiple has an even (0) or odd (1)
+              // number of prime factors
+              else if (factor != 0)
+                set(mi, factor ^ 1);
+            }
+
+            if (prime <= sqrtz)
+            {
+              int64_t j = 0;
+              int64_t square = prime * prime;
+              multiple = next_multiple(square, low, &j);
+
+              // Sieve out numbers that are not square free
+              // i.e. numbers for which moebius(n) = 0.
+              for (; multiple <= high; multiple = square * to_number(j++))
+                set(to_index(multiple), 0);
+            }
+          }
+        }
+
+        // Iterate over primes from [y+1, high]
+        start = std::max(start, y + 1);
+
+        if (start <= high)
+        {
+          it.jump_to(start, high);
+
+          // y < prime <= z
+          while (true)
+          {
+            int64_t i = 0;
+            int64_t prime = it.next_prime();
+            int64_t next = next_multiple(prime, low, &i);
+
+            if (prime > high)
+              break;
+
+            // Sieve out primes > y &&
+            // Sieve out numbers with prime factors > y
+            for (; next <= high; next = prime * to_number(i++))
+              set(to_index(next), 0);
+          }
+        }
+      }
+    }
+  }
+
+  /// Returns the value that must be compared with is_leaf(m)
+  /// for the prime with index b (prime = primes[b]).
+  /// n = to_number(m) is a hard special leaf if:
+  /// leaf_key(prime, b) < is_leaf(m).
+  ///
+  static int64_t leaf_key(int64_t prime, int64_t b)
+  {
+    unused_param(prime);
+    return 2 * b + 1;
+  }
+
+  /// Returns true if n (with n = to_number(index)) is a
+  /// hard special leaf in the D formula of Xavier
+  /// Gourdon's prime counting algorithm.
+  ///
+  /// Return value:
+  ///
+  /// 1) MAX - 1            if n = 1
+  /// 2) MAX                if n is a prime
+  /// 3) 0                  if n has a prime factor > y
+  /// 4) 0                  if moebius(n) = 0
+  /// 5) 2 * pi[lpf]        if moebius(n) = 1
+  /// 6) 2 * pi[lpf] + 1    if moebius(n) = -1
+  ///
+  ALWAYS_INLINE int64_t is_leaf(int64_t index) const
+  {
+    return (int64_t) get(index);
+  }
+
+  /// Get the Möbius function value of the number
+  /// n = to_number(index).
+  ///
+  /// https://en.wikipedia.org/wiki/Möbius_function
+  /// mu(n) = 1 if n is a square-free integer with an even number of prime factors.
+  /// mu(n) = −1 if n is a square-free integer with an odd number of prime factors.
+  /// mu(n) = 0 if n has a squared prime factor.
+  ///
+  int64_t mu(int64_t index) const
+  {
+    uint64_t factor = get(index);
+
+    // mu(n) = 0 is disabled by default for performance
+    // reasons, we only enable it for testing.
+    #if defined(ENABLE_MU_0_TESTING)
+      if (factor == 0)
+        return 0;
+    #else
+      ASSERT(factor != 0);
+    #endif
+
+    if (factor & 1)
+      return -1;
+    else
+      return 1;
+  }
+
+  /// Number of bits used per entry
+  int bits() const
+  {
+    return bits_;
+  }
+
+  /// Largest value stored in the lookup table
+  int64_t max_value() const
+  {
+    return (int64_t) max_;
+  }
+
+  static maxint_t max()
+  {
+    maxint_t T_MAX = pstd::numeric_limits<uint32_t>::max();
+    return ipow<2>(T_MAX - 1) - 1;
+  }
+
+private:
+  /// Branchfree read of the bits_ wide entry at index.
+  /// An entry may straddle 2 consecutive 64-bit words,
+  /// the last word of words_ is padding.
+  ///
+  ALWAYS_INLINE uint64_t get(uint64_t index) const
+  {
+    uint64_t bit = index * bits_;
+    uint64_t i = bit / 64;
+    uint64_t shift = bit % 64;
+    uint64_t lo = words_[i] >> shift;
+    uint64_t hi = (words_[i + 1] << 1) << (63 - shift);
+    return (lo | hi) & max_;
+  }
+
+  void set(uint64_t index, uint64_t value)
+  {
+    ASSERT(value <= max_);
+    uint64_t bit = index * bits_;
+    uint64_t i = bit / 64;
+    uint64_t shift = bit % 64;
+    words_[i] &= ~(max_ << shift);
+    words_[i] |= value << shift;
+
+    if (shift + bits_ > 64)
+    {
+      uint64_t hi_bits = 64 - shift;
+      words_[i + 1] &= ~(max_ >> hi_bits);
+      words_[i + 1] |= value >> hi_bits;
+    }
+  }
+
+  Vector<uint64_t> words_;
+  uint64_t max_ = 0;
+  int bits_ = 0;
+};
+
+} // namespace
+
+#endif
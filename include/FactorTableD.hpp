@@ -53,6 +53,7 @@
 #include <imath.hpp>
 #include <int128_t.hpp>
 #include <macros.hpp>
+#include <Numa.hpp>
 #include <Vector.hpp>
 
 #include <algorithm>
@@ -77,6 +78,7 @@ public:
     z = std::max<int64_t>(1, z);
     T T_MAX = pstd::numeric_limits<T>::max();
     factor_.resize(to_index(z) + 1);
+    numa_place(factor_.data(), factor_.size() * sizeof(T));
 
     // mu(1) = 1.
     // 1 has zero prime factors, hence 1 has an even
@@ -179,6 +181,17 @@ public:
     }
   }
 
+  /// Returns the value that must be compared with is_leaf(m)
+  /// for the prime with index b (prime = primes[b]).
+  /// n = to_number(m) is a hard special leaf if:
+  /// leaf_key(prime, b) < is_leaf(m).
+  ///
+  static int64_t leaf_key(int64_t prime, int64_t b)
+  {
+    unused_param(b);
+    return prime;
+  }
+
   /// Returns true if n (with n = to_number(index)) is a
   /// hard special leaf in the D formula of Xavier
   /// Gourdon's prime counting algorithm.
@@ -16,7 +16,14 @@
 #ifndef LOADBALANCERAC_HPP
 #define LOADBALANCERAC_HPP
 
-#include <OmpLock.hpp>
+#include <AsyncContext.hpp>
+#include <LoadBalancerTrace.hpp>
+#include <StatusReporter.hpp>
+#include <macros.hpp>
+#include <primecount-config.hpp>
+
+#include <atomic>
+#include <memory>
 #include <stdint.h>
 
 namespace primecount {
@@ -26,29 +33,53 @@ struct ThreadDataAC
   int64_t low = 0;
   int64_t segments = 0;
   int64_t segment_size = 0;
+  maxint_t sum = 0;
+  double init_secs = 0;
   double secs = 0;
 };
 
+/// LoadBalancerAC is lock-free. Its state (low, segment size,
+/// number of segments) is packed into a single 64-bit atomic
+/// integer: the upper 54 bits hold low and the lower 10 bits
+/// hold the exponents of the 2x increases of the segment size
+/// and of the number of segments. Threads reserve the next
+/// work interval using a single atomic fetch_add on the
+/// packed state.
+///
 class LoadBalancerAC
 {
 public:
   LoadBalancerAC(int64_t sqrtx, int64_t y, int threads, bool is_print);
   bool get_work(ThreadDataAC& thread);
+  bool is_cancelled() const { return async_ && async_->is_cancelled(); }
 
 private:
-  void print_status(double current_time);
-  int64_t low_ = 0;
+  static constexpr int exp_bits = 5;
+  static constexpr int max_exp = (1 << exp_bits) - 1;
+  static constexpr int low_shift = exp_bits * 2;
+  void increase(const ThreadDataAC& thread, uint64_t state, double time);
+  void report_progress(double time);
+  void print_status();
+  int64_t get_segments(uint64_t state) const;
+  int64_t get_segment_size(uint64_t state) const;
   int64_t sqrtx_ = 0;
   int64_t y_ = 0;
   int64_t segments_ = 0;
-  int64_t segment_size_ = 0;
-  int64_t segment_nr_ = 0;
+  int64_t segment_size_[max_exp + 1] = { 0 };
   int64_t max_segment_size_ = 0;
-  double start_time_ = 0;
-  double print_time_ = 0;
   int threads_ = 0;
   bool is_print_ = false;
-  OmpLock lock_;
+  bool is_trace_ = false;
+  AsyncContext* async_ = nullptr;
+  // Use padding to avoid CPU false sharing
+  MAYBE_UNUSED char pad1[MAX_CACHE_LINE_SIZE];
+  std::atomic<uint64_t> state_;
+  MAYBE_UNUSED char pad2[MAX_CACHE_LINE_SIZE];
+  std::atomic<int64_t> segment_nr_;
+  std::atomic<double> start_time_;
+  std::atomic<double> print_time_;
+  std::atomic<bool> reporting_;
+  std::unique_ptr<StatusReporter> reporter_;
 };
 
 } // namespace
@@ -14,8 +14,12 @@
 #define LOADBALANCERP2_HPP
 
 #include <int128_t.hpp>
+#include <AsyncContext.hpp>
 #include <OmpLock.hpp>
+#include <StatusReporter.hpp>
 
+#include <atomic>
+#include <memory>
 #include <stdint.h>
 
 namespace primecount {
@@ -34,11 +38,14 @@ private:
   int64_t sieve_limit_ = 0;
   int64_t min_thread_dist_ = 0;
   int64_t thread_dist_ = 0;
-  double time_ = 0;
   int threads_ = 0;
   int precision_ = 0;
   bool is_print_ = false;
+  AsyncContext* async_ = nullptr;
   OmpLock lock_;
+  // Progress snapshot for the status reporter thread
+  std::atomic<int64_t> status_low_{0};
+  std::unique_ptr<StatusReporter> reporter_;
 };
 
 } // namespace
@@ -14,8 +14,13 @@
 #include <int128_t.hpp>
 #include <macros.hpp>
 #include <OmpLock.hpp>
+#include <AsyncContext.hpp>
+#include <LoadBalancerTrace.hpp>
+#include <StatusReporter.hpp>
 #include <StatusS2.hpp>
 
+#include <atomic>
+#include <memory>
 #include <stdint.h>
 
 namespace primecount {
@@ -28,6 +33,16 @@ struct ThreadData
   maxint_t sum = 0;
   double init_secs = 0;
   double secs = 0;
+  // Work interval reserved for this thread which is
+  // contiguous with its current work interval.
+  int64_t next_low = 0;
+  int64_t next_high = 0;
+  // The current work interval starts where the
+  // previous work interval of this thread ended.
+  bool is_contiguous = false;
+  // phi[] and the sieve have been carried forward
+  // from the previous work interval (ThreadSieve.hpp).
+  bool is_carried = false;
 
   void start_time()
   {
@@ -57,12 +72,15 @@ public:
   LoadBalancerS2(maxint_t x, int64_t sieve_limit, maxint_t sum_approx, int threads, bool is_print);
   bool get_work(ThreadData& thread);
   maxint_t get_sum() const;
+  void print_init_time();
 
 private:
+  void reserve_next(ThreadData& thread);
   void update_load_balancing(const ThreadData& thread);
   void update_number_of_segments(const ThreadData& thread);
   void update_segment_size();
   double remaining_secs() const;
+  void print_status();
 
   int64_t low_ = 0;
   int64_t max_low_ = 0;
@@ -73,9 +91,22 @@ private:
   maxint_t sum_ = 0;
   maxint_t sum_approx_ = 0;
   double time_ = 0;
+  double init_secs_ = 0;
+  double last_init_secs_ = 0;
+  double thread_secs_ = 0;
+  int64_t work_units_ = 0;
+  int64_t carried_units_ = 0;
+  uint64_t allocations_ = 0;
+  bool is_contiguous_ = false;
   bool is_print_ = false;
+  bool is_trace_ = false;
   StatusS2 status_;
+  AsyncContext* async_ = nullptr;
   OmpLock lock_;
+  // Progress snapshot for the status reporter thread
+  std::atomic<int64_t> status_low_{0};
+  std::atomic<double> status_sum_{0};
+  std::unique_ptr<StatusReporter> reporter_;
 };
 
 } // namespace
@@ -0,0 +1,86 @@
+///
+/// @file  LoadBalancerTrace.hpp
+/// @brief Optional trace of the load balancers (LoadBalancerS2
+///        and LoadBalancerAC). If the PRIMECOUNT_TRACE_FILE
+///        environment variable is set, every get_work() call is
+///        appended as a binary TraceRecord to that file. The
+///        trace can be replayed offline using different load
+///        balancing policies and thread counts using
+///        scripts/replay_load_balancer.cpp (which contains a copy
+///        of the TraceRecord struct).
+///
+///        File format: the 8 byte magic "PCTRACE1" followed by
+///        TraceRecords (64 bytes each, native byte order). Each
+///        load balancer first writes a TRACE_BEGIN_S2 or
+///        TRACE_BEGIN_AC record followed by its TRACE_WORK
+///        records. For TRACE_BEGIN records: low = sieve limit
+///        (LoadBalancerS2) or sqrt(x) (LoadBalancerAC),
+///        segments = threads, segment_size = initial segment
+///        size, sum = sum_approx (LoadBalancerS2) or y
+///        (LoadBalancerAC).
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef LOADBALANCERTRACE_HPP
+#define LOADBALANCERTRACE_HPP
+
+#include <int128_t.hpp>
+#include <stdint.h>
+
+namespace primecount {
+
+enum TraceType
+{
+  TRACE_BEGIN_S2,
+  TRACE_BEGIN_AC,
+  TRACE_WORK
+};
+
+/// A TRACE_WORK record describes the work interval
+/// [low, low + segments * segment_size[ that has been
+/// completed by thread in secs seconds (init_secs of
+/// which were spent initializing the thread's data
+/// structures) and the sum that has been computed.
+///
+struct TraceRecord
+{
+  int32_t type;
+  int32_t thread;
+  int64_t low;
+  int64_t segments;
+  int64_t segment_size;
+  double secs;
+  double init_secs;
+  int64_t sum_high;
+  uint64_t sum_low;
+};
+
+static_assert(sizeof(TraceRecord) == 64, "TraceRecord must be 64 bytes");
+
+/// Returns true if PRIMECOUNT_TRACE_FILE is set
+bool is_trace();
+
+/// Called by the load balancer's constructor
+void trace_begin(TraceType type,
+                 int64_t limit,
+                 int threads,
+                 int64_t segment_size,
+                 maxint_t sum);
+
+/// Called by get_work() for the previous work interval
+/// of the calling thread (thread-safe).
+///
+void trace_work(int64_t low,
+                int64_t segments,
+                int64_t segment_size,
+                double secs,
+                double init_secs,
+                maxint_t sum);
+
+} // namespace
+
+#endif
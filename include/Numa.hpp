@@ -0,0 +1,145 @@
+///
+/// @file  Numa.hpp
+/// @brief NUMA aware placement of the large read-mostly lookup
+///        tables (PiTable, FactorTableD) and of the worker threads.
+///        On multi-socket servers these tables are filled by
+///        whichever threads happen to run, hence threads running
+///        on the remote socket pay the cross-socket latency on
+///        each lookup. The NUMA policy (--numa option) can be:
+///
+///        NUMA_DEFAULT:    Use the operating system's default
+///                         (first touch) memory placement.
+///        NUMA_INTERLEAVE: Interleave the pages of the lookup
+///                         tables across all NUMA nodes.
+///        NUMA_REPLICATE:  Each NUMA node gets its own copy of
+///                         the lookup tables, threads access the
+///                         copy of the node they are running on.
+///
+///        Additionally the OpenMP threads can be pinned to NUMA
+///        nodes (--numa-pin option). libnuma is used if available,
+///        else the Linux system calls are used directly. On other
+///        operating systems these functions do nothing.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef NUMA_HPP
+#define NUMA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace primecount {
+
+enum NumaPolicy
+{
+  NUMA_DEFAULT,
+  NUMA_INTERLEAVE,
+  NUMA_REPLICATE
+};
+
+void set_numa_policy(NumaPolicy policy);
+void set_numa_policy(const std::string& policy);
+NumaPolicy get_numa_policy();
+void set_numa_pin(bool pin);
+bool is_numa_pin();
+
+/// Returns true if a NUMA policy or thread
+/// pinning has been selected by the user.
+bool is_numa();
+
+/// Human readable description e.g. "interleave, 2 nodes"
+std::string numa_policy_str();
+
+/// Number of NUMA nodes, 1 if unknown
+int numa_nodes();
+
+/// NUMA node of the CPU the calling thread is running on
+int numa_current_node();
+
+/// Pin the calling OpenMP thread to a NUMA node if the
+/// --numa-pin option is used. The threads are assigned
+/// to the NUMA nodes in contiguous blocks. The OpenMP
+/// threads (including the calling thread) are reused
+/// after the parallel region, hence the destructor
+/// restores the thread's previous CPU affinity.
+///
+class NumaPinThread
+{
+public:
+  NumaPinThread(int threads);
+  ~NumaPinThread();
+  NumaPinThread(const NumaPinThread&) = delete;
+  NumaPinThread& operator=(const NumaPinThread&) = delete;
+private:
+  bool is_pinned_ = false;
+};
+
+/// Apply the NUMA policy to the memory [ptr, ptr + bytes[.
+/// Must be called before the memory is touched for the first
+/// time, i.e. right after allocating a lookup table and
+/// before it is filled. Only whole pages are affected.
+///
+void numa_place(void* ptr, std::size_t bytes);
+
+/// Lookup tables that are constructed while a NumaNode
+/// object is alive are placed on that NUMA node.
+///
+class NumaNode
+{
+public:
+  NumaNode(int node);
+  ~NumaNode();
+private:
+  int previous_;
+};
+
+/// If the NUMA_REPLICATE policy is used, NumaReplicas
+/// constructs one copy of the lookup table T per NUMA
+/// node, else only a single copy is constructed.
+///
+template <typename T>
+class NumaReplicas
+{
+public:
+  template <typename... Args>
+  NumaReplicas(const Args&... args)
+  {
+    int copies = 1;
+    if (get_numa_policy() == NUMA_REPLICATE)
+      copies = numa_nodes();
+
+    if (copies == 1)
+      replicas_.emplace_back(new T(args...));
+    else
+    {
+      for (int node = 0; node < copies; node++)
+      {
+        NumaNode numaNode(node);
+        replicas_.emplace_back(new T(args...));
+      }
+    }
+  }
+
+  /// Copy of the NUMA node the calling thread is running on
+  const T& local() const
+  {
+    if (replicas_.size() == 1)
+      return *replicas_[0];
+
+    std::size_t node = (std::size_t) numa_current_node();
+    return *replicas_[node % replicas_.size()];
+  }
+
+private:
+  std::vector<std::unique_ptr<T>> replicas_;
+};
+
+} // namespace
+
+#endif
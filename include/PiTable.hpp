@@ -8,6 +8,13 @@
 ///        type, one array element (8 bytes) corresponds to an
 ///        interval of size 30 * 8 = 240.
 ///
+///        By default each 64-bit word is stored together with a
+///        64-bit prime count (16 bytes per 240 numbers). The compact
+///        layout instead stores 7 words and a single prime count in
+///        each 64-byte block (cache line), i.e. 64 bytes per 1680
+///        numbers. This uses 43% less memory, but operator[] needs
+///        up to 7 POPCNT instructions instead of 1.
+///
 /// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
 ///
 /// This file is distributed under the BSD License. See the COPYING
@@ -29,7 +36,14 @@ namespace primecount {
 class PiTable : public BitSieve240
 {
 public:
-  PiTable(uint64_t max_x, int threads);
+  PiTable(uint64_t max_x, int threads, bool is_compact = false);
+  PiTable(const PiTable&) = delete;
+  PiTable& operator=(const PiTable&) = delete;
+
+  bool is_compact() const
+  {
+    return blocks_ != nullptr;
+  }
 
   uint64_t size() const
   {
@@ -49,9 +63,22 @@ public:
     if (x < pi_tiny_.size())
       return pi_tiny_[x];
 
+    uint64_t bitmask = unset_larger_[x % 240];
+
+    if (blocks_)
+    {
+      // Compact layout: add the 1-bits of
+      // the previous words of the block.
+      uint64_t i = x / 240;
+      const block_t& block = blocks_[i / 7];
+      uint64_t count = block.count;
+      for (uint64_t j = 0; j < i % 7; j++)
+        count += popcnt64(block.bits[j]);
+      return count + popcnt64(block.bits[i % 7] & bitmask);
+    }
+
     uint64_t count = pi_[x / 240].count;
     uint64_t bits = pi_[x / 240].bits;
-    uint64_t bitmask = unset_larger_[x % 240];
     return count + popcnt64(bits & bitmask);
   }
 
@@ -74,12 +101,36 @@ private:
     uint64_t bits;
   };
 
+  /// Compact layout, 64 bytes per 1680 numbers
+  struct block_t
+  {
+    uint64_t count;
+    uint64_t bits[7];
+  };
+
+  uint64_t& bits(uint64_t i)
+  {
+    if (blocks_)
+      return blocks_[i / 7].bits[i % 7];
+    else
+      return pi_[i].bits;
+  }
+
+  void set_count(uint64_t i, uint64_t count)
+  {
+    if (!blocks_)
+      pi_[i].count = count;
+    else if (i % 7 == 0)
+      blocks_[i / 7].count = count;
+  }
+
   void init(uint64_t limit, uint64_t cache_limit, int threads);
-  void init_bits(uint64_t low, uint64_t high, uint64_t thread_num);
-  void init_count(uint64_t low, uint64_t high, uint64_t thread_num);
+  uint64_t init_bits(uint64_t low, uint64_t high, Vector<uint64_t>& sieve);
+  void init_count(uint64_t low, uint64_t high, const Vector<uint64_t>& sieve, uint64_t count);
   static const Array<pi_t, 128> pi_cache_;
   Vector<pi_t> pi_;
-  Vector<uint64_t> counts_;
+  Vector<uint64_t> compact_;
+  block_t* blocks_ = nullptr;
   uint64_t max_x_;
 };
 
@@ -0,0 +1,35 @@
+///
+/// @file  PrimesieveThreads.hpp
+/// @brief primesieve::count_primes() uses all CPU cores by
+///        default. When it is called from inside of an OpenMP
+///        parallel region (e.g. pi(x / prime) in B(x, y)) this
+///        oversubscribes the CPU. PrimesieveThreads sets
+///        primesieve's number of threads until the end of the
+///        current scope. primesieve's number of threads is a
+///        global setting, the objects of concurrent nested
+///        computations are reference counted and the previous
+///        setting is restored by the last object.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef PRIMESIEVETHREADS_HPP
+#define PRIMESIEVETHREADS_HPP
+
+namespace primecount {
+
+class PrimesieveThreads
+{
+public:
+  PrimesieveThreads(int threads);
+  ~PrimesieveThreads();
+  PrimesieveThreads(const PrimesieveThreads&) = delete;
+  PrimesieveThreads& operator=(const PrimesieveThreads&) = delete;
+};
+
+} // namespace
+
+#endif
@@ -31,6 +31,7 @@
 #include <macros.hpp>
 #include <Vector.hpp>
 #include <popcnt.hpp>
+#include <primesieve.hpp>
 
 #include <stdint.h>
 #include <algorithm>
@@ -95,6 +96,9 @@ private:
   };
 
   Vector<pi_t> pi_;
+  // Reused for each segment, this avoids
+  // reallocating the iterator's memory.
+  primesieve::iterator it_;
   uint64_t low_ = 0;
   uint64_t high_ = 0;
 };
@@ -73,9 +73,18 @@ class Sieve
 {
 public:
   Sieve(uint64_t low, uint64_t segment_size, uint64_t wheel_size);
+  void init(uint64_t low, uint64_t segment_size, uint64_t wheel_size);
   void cross_off(uint64_t prime, uint64_t i);
   void cross_off_count(uint64_t prime, uint64_t i);
   static uint64_t get_segment_size(uint64_t size);
+  uint64_t segment_size() const;
+
+  /// Used when the sieve is reused for the next contiguous
+  /// work interval [low, ...[, rebalances the counter array.
+  void rebalance_counter(uint64_t low)
+  {
+    allocate_counter(low);
+  }
 
   uint64_t get_total_count() const
   {
@@ -291,7 +300,6 @@ private:
   void init_counter(uint64_t low, uint64_t high);
   void reset_counter();
   void reset_sieve(uint64_t low, uint64_t high);
-  uint64_t segment_size() const;
   static const Array<uint64_t, 240> unset_smaller;
   static const Array<uint64_t, 240> unset_larger;
 
@@ -0,0 +1,47 @@
+///
+/// @file  StatusReporter.hpp
+/// @brief The StatusReporter runs a background thread that prints
+///        the status of a computation (--status option) at a fixed
+///        rate. The worker threads only store their progress into
+///        atomic variables, all formatting and I/O is done by the
+///        reporter thread. Hence the worker threads never block on
+///        a slow terminal or log pipe while holding a lock.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef STATUSREPORTER_HPP
+#define STATUSREPORTER_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace primecount {
+
+class StatusReporter
+{
+public:
+  /// Calls print() every 0.1 seconds in a background
+  /// thread and once more when the reporter is stopped.
+  ///
+  StatusReporter(const std::function<void()>& print);
+  ~StatusReporter();
+  void stop();
+
+private:
+  void run();
+  std::function<void()> print_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+} // namespace
+
+#endif
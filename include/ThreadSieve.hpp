@@ -0,0 +1,124 @@
+///
+/// @file  ThreadSieve.hpp
+/// @brief The phi[] lookup table and the Sieve of a thread that
+///        computes the hard special leaves (S2_hard.cpp, D.cpp).
+///        Initializing phi[] using phi_vector() is expensive, hence
+///        if the LoadBalancerS2 assigns the thread a work interval
+///        that is contiguous with its previous work interval, the
+///        thread carries forward its phi[] and its Sieve instead
+///        of recomputing them.
+///
+///        After processing [low, high[ phi[b] = phi(high - 1, b - 1)
+///        for min_b <= b <= max_b (or b is larger than the last b
+///        that was processed in the last segment, which implies
+///        that b has no more special leaves >= high). The sieving
+///        primes of the Sieve (wheel) are positioned at high.
+///
+///        Otherwise phi[] and the Sieve are reinitialized, but
+///        their memory (and the memory of phi_vector()'s cache)
+///        is reused, which avoids thousands of allocations in the
+///        first phase of the computation where the LoadBalancerS2
+///        hands out many tiny work intervals.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef THREADSIEVE_HPP
+#define THREADSIEVE_HPP
+
+#include <PiTable.hpp>
+#include <Sieve.hpp>
+#include <Vector.hpp>
+#include <phi_vector.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <stdint.h>
+
+namespace primecount {
+
+class ThreadSieve
+{
+public:
+  /// Initialize phi[b] = phi(low - 1, b - 1) for
+  /// min_b <= b <= max_b and the sieve for the work
+  /// interval [low, high[. If is_contiguous and the
+  /// previous work interval of the thread ended at low
+  /// phi[] and the sieve are carried forward, in this
+  /// case true is returned.
+  ///
+  template <typename Primes>
+  bool init(bool is_contiguous,
+            int64_t low,
+            int64_t high,
+            int64_t segment_size,
+            int64_t min_b,
+            int64_t max_b,
+            const Primes& primes,
+            const PiTable& pi)
+  {
+    is_contiguous = is_contiguous &&
+                    sieve_ &&
+                    low == high_ &&
+                    max_b <= max_b_ &&
+                    (int64_t) sieve_->segment_size() == segment_size;
+
+    if (is_contiguous)
+    {
+      // The bounds of the next work interval are larger, hence
+      // it may contain special leaves with b < min_b_. phi(x, a)
+      // is cheap to compute for small a, hence we only compute
+      // the missing phi[b] values.
+      if (min_b < min_b_)
+      {
+        phi_vector(low, min_b_ - 1, primes, pi, phi_low_, arena_);
+        std::copy(phi_low_.begin() + min_b, phi_low_.end(), phi_.begin() + min_b);
+      }
+
+      sieve_->rebalance_counter(low);
+    }
+    else
+    {
+      // Reuse the memory of the previous work interval
+      phi_vector(low, max_b, primes, pi, phi_, arena_);
+
+      if (sieve_)
+        sieve_->init(low, segment_size, max_b);
+      else
+        sieve_.reset(new Sieve(low, segment_size, max_b));
+    }
+
+    // phi[b] will only be updated for min_b <= b <= max_b
+    min_b_ = min_b;
+    max_b_ = max_b;
+    high_ = high;
+
+    return is_contiguous;
+  }
+
+  Vector<int64_t>& phi()
+  {
+    return phi_;
+  }
+
+  Sieve& sieve()
+  {
+    return *sieve_;
+  }
+
+private:
+  Vector<int64_t> phi_;
+  Vector<int64_t> phi_low_;
+  PhiVectorArena arena_;
+  std::unique_ptr<Sieve> sieve_;
+  int64_t min_b_ = 0;
+  int64_t max_b_ = 0;
+  int64_t high_ = -1;
+};
+
+} // namespace
+
+#endif
@@ -21,6 +21,13 @@
 
 namespace primecount {
 
+/// Number of heap allocations of all Vectors, used to
+/// report the number of allocations of a computation.
+/// Only counted if ENABLE_ALLOCATION_STATS is defined
+/// (debug builds or cmake -DWITH_ALLOCATION_STATS=ON).
+void count_vector_allocation() noexcept;
+uint64_t get_vector_allocations() noexcept;
+
 /// Vector is a dynamically growing array.
 /// It has the same API (though not complete) as std::vector but its
 /// resize() method does not default initialize memory for built-in
@@ -303,6 +310,9 @@ private:
 
     T* old = array_;
     array_ = Allocator().allocate(new_capacity);
+#if defined(ENABLE_ALLOCATION_STATS)
+    count_vector_allocation();
+#endif
     end_ = array_ + old_size;
     capacity_ = array_ + new_capacity;
     ASSERT(size() < capacity());
@@ -175,6 +175,16 @@ template<typename T> struct make_unsigned {
   template<> struct make_unsigned<uint128_t> { using type = uint128_t; };
 #endif
 
+// pstd::make_signed
+template<typename T> struct make_signed {
+  using type = typename std::make_signed<T>::type;
+};
+
+#if defined(HAVE_INT128_T)
+  template<> struct make_signed<int128_t> { using type = int128_t; };
+  template<> struct make_signed<uint128_t> { using type = int128_t; };
+#endif
+
 // pstd::numeric_limits
 template<typename T> struct numeric_limits {
   static constexpr T min() { return std::numeric_limits<T>::min(); }
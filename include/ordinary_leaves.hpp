@@ -0,0 +1,264 @@
+///
+/// @file  ordinary_leaves.hpp
+/// @brief Parallel computation of the ordinary leaves, used by
+///        the S1 formula of the Deleglise-Rivat algorithm and
+///        by the Phi0 formula of Xavier Gourdon's algorithm.
+///
+///        We iterate over the square free numbers n <= limit
+///        whose prime factors are > primes[k] and <= primes[pi_y]
+///        and compute: sum mu(n) * phi_tiny(x / n, k).
+///
+///        The square free numbers form a tree, the children of
+///        the node n (with least prime factor primes[b]) are the
+///        nodes n * primes[c] with c < b. The cost of the subtree
+///        rooted at n is roughly limit / n, hence the subtrees of
+///        the first few primes are much more expensive than all
+///        other subtrees. In order to scale well we split the
+///        expensive subtrees into many tasks of roughly equal
+///        cost which are then processed using dynamic scheduling.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef ORDINARY_LEAVES_HPP
+#define ORDINARY_LEAVES_HPP
+
+#include <AsyncContext.hpp>
+#include <PhiTiny.hpp>
+#include <fast_div.hpp>
+#include <int128_t.hpp>
+#include <Vector.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace {
+
+using namespace primecount;
+
+/// Iteratively enumerate the square free numbers
+/// n = square_free * m <= limit whose prime factors are
+/// > primes[b] and compute sum mu(n) * phi_tiny(x / n, k).
+/// This algorithm is described in section 2.2 of the paper:
+/// Douglas Staple, "The Combinatorial Algorithm For Computing
+/// pi(x)", arXiv:1503.01839, 6 March 2015.
+///
+/// Instead of recursively calling phi_tiny(x / n, k) for each
+/// node of the tree we use an explicit stack and store the
+/// square free numbers (and their Möbius values) in a small
+/// buffer. Once the buffer is full we compute phi_tiny() for
+/// all numbers of the buffer in a tight loop. The divisor n is
+/// always < 2^64 hence we can use fast_div() which avoids the
+/// slow 128-bit / 128-bit division if x is a 128-bit integer.
+///
+template <typename T, typename P>
+T ordinary_leaves_thread(T x,
+                         int64_t limit,
+                         uint64_t b,
+                         int64_t k,
+                         T square_free,
+                         int mu,
+                         const Vector<P>& primes)
+{
+  // n <= limit < 2^63, hence n has at most
+  // 63 prime factors.
+  Array<uint64_t, 64> stack_n;
+  Array<uint64_t, 64> stack_b;
+  Array<uint64_t, 1024> leaves;
+  Array<int8_t, 1024> leaves_mu;
+  std::size_t size = 0;
+  uint64_t pi_y = primes.size();
+  T sum = 0;
+
+  auto flush = [&]()
+  {
+    for (std::size_t i = 0; i < size; i++)
+      sum += leaves_mu[i] * phi_tiny(fast_div(x, leaves[i]), k);
+    size = 0;
+  };
+
+  // Number of nested prime factors, the Möbius value
+  // of the children at depth d is -mu * (-1)^d.
+  int depth = 0;
+  stack_n[0] = (uint64_t) square_free;
+  stack_b[0] = b;
+
+  while (depth >= 0)
+  {
+    uint64_t c = ++stack_b[depth];
+
+    if (c < pi_y)
+    {
+      T next = (T) stack_n[depth] * primes[c];
+
+      if (next <= limit)
+      {
+        leaves[size] = (uint64_t) next;
+        leaves_mu[size] = (int8_t) ((depth & 1) ? mu : -mu);
+        if (++size == leaves.size())
+          flush();
+
+        depth++;
+        stack_n[depth] = (uint64_t) next;
+        stack_b[depth] = c;
+        continue;
+      }
+    }
+
+    depth--;
+  }
+
+  flush();
+  return sum;
+}
+
+/// A task computes the contribution of the children
+/// square_free * primes[c] with c_lo <= c <= c_hi
+/// (and of all of their descendants).
+///
+template <typename T>
+struct LeafTask
+{
+  T square_free;
+  int64_t c_lo;
+  int64_t c_hi;
+  int mu;
+};
+
+template <typename T, typename P>
+T ordinary_leaves_task(T x,
+                       int64_t limit,
+                       int64_t k,
+                       const LeafTask<T>& task,
+                       const Vector<P>& primes)
+{
+  T sum = 0;
+
+  for (int64_t c = task.c_lo; c <= task.c_hi; c++)
+  {
+    T next = task.square_free * primes[c];
+    T phi_xn = phi_tiny(x / next, k);
+
+    sum += task.mu * phi_xn;
+    sum += ordinary_leaves_thread(x, limit, c, k, next, task.mu, primes);
+  }
+
+  return sum;
+}
+
+/// Split the children of square_free into tasks whose estimated
+/// cost is <= target. The cost of the child square_free * p is
+/// estimated as limit / (square_free * p) and the cost of all
+/// children with primes inside [p1, p2] is estimated using
+/// Mertens' 2nd theorem: sum 1/p ~ log(log(p2)) - log(log(p1)).
+/// Children whose cost is > target are themselves split
+/// recursively. The contribution of these children (but not of
+/// their descendants) is computed here and added to sum.
+///
+template <typename T, typename P>
+void split_tasks(T x,
+                 int64_t limit,
+                 int64_t k,
+                 T square_free,
+                 int64_t b,
+                 int mu,
+                 double target,
+                 const Vector<P>& primes,
+                 Vector<LeafTask<T>>& tasks,
+                 T& sum)
+{
+  // Children: square_free * primes[c] <= limit
+  int64_t max_prime = (int64_t)(limit / square_free);
+  auto end = std::upper_bound(primes.begin() + b + 1, primes.end(), max_prime);
+  int64_t c_max = (int64_t)(end - primes.begin()) - 1;
+  double sf = (double) square_free;
+
+  for (int64_t c = b + 1; c <= c_max;)
+  {
+    double prime = (double) primes[c];
+    double cost = limit / (sf * prime);
+
+    if (cost > target)
+    {
+      T next = square_free * primes[c];
+      sum += mu * phi_tiny(x / next, k);
+      split_tasks(x, limit, k, next, c, -mu, target, primes, tasks, sum);
+      c += 1;
+    }
+    else
+    {
+      // Find the largest prime such that the cost
+      // of the children [primes[c], prime] <= target.
+      double loglog = std::log(std::log(std::max(prime, 3.0)));
+      double max_p = std::exp(std::exp(loglog + target * sf / limit));
+      max_p = std::min(max_p, (double) max_prime);
+      auto last = std::upper_bound(primes.begin() + c, end, max_p,
+                                   [](double p, P q) { return p < q; });
+      int64_t c_hi = std::max(c, (int64_t)(last - primes.begin()) - 1);
+      tasks.push_back(LeafTask<T>{square_free, c, c_hi, mu});
+      c = c_hi + 1;
+    }
+  }
+}
+
+/// Parallel computation of the ordinary leaves:
+/// sum mu(n) * phi_tiny(x / n, k), n <= limit.
+/// Run time: O(limit)
+/// Memory usage: O(pi(y))
+///
+template <typename T, typename P>
+T ordinary_leaves_OpenMP(T x,
+                         int64_t limit,
+                         int64_t k,
+                         const Vector<P>& primes,
+                         int threads)
+{
+  T sum = phi_tiny(x, k);
+  int64_t pi_y = primes.size() - 1;
+
+  if (k >= pi_y)
+    return sum;
+
+  // Estimated total cost: limit * sum 1/p, with
+  // primes[k] < p <= primes[pi_y]. We create about
+  // 16 tasks per thread, the expensive tasks are
+  // split into smaller tasks.
+  double p1 = std::max((double) primes[k + 1], 3.0);
+  double p2 = std::max((double) primes[pi_y], p1);
+  double total = limit * (std::log(std::log(p2)) - std::log(std::log(p1)));
+  total += (double) limit / p1;
+  double target = total / (threads * 16.0);
+  target = std::max(target, 1.0);
+
+  Vector<LeafTask<T>> tasks;
+
+  if (threads > 1)
+    split_tasks(x, limit, k, (T) 1, k, -1, target, primes, tasks, sum);
+  else
+  {
+    auto end = std::upper_bound(primes.begin() + k + 1, primes.end(), limit);
+    int64_t c_max = (int64_t)(end - primes.begin()) - 1;
+    tasks.push_back(LeafTask<T>{(T) 1, k + 1, c_max, -1});
+  }
+
+  int64_t num_tasks = tasks.size();
+  AsyncContext* async = get_async_context();
+
+  // Skip the remaining tasks if the asynchronous
+  // computation has been cancelled.
+  #pragma omp parallel for schedule(dynamic, 1) num_threads(threads) reduction(+: sum)
+  for (int64_t i = 0; i < num_tasks; i++)
+    if (!async || !async->is_cancelled())
+      sum += ordinary_leaves_task(x, limit, k, tasks[i], primes);
+
+  return sum;
+}
+
+} // namespace
+
+#endif
@@ -16,6 +16,27 @@
 
 namespace primecount {
 
+/// Memory of phi_vector() that is reused across the work
+/// intervals of a thread (see ThreadSieve.hpp), this avoids
+/// reallocating the cache of phi(x, i) results and the
+/// phi[] vector for each work interval. Each thread must
+/// use its own PhiVectorArena.
+///
+struct PhiVectorArena
+{
+  /// Packing sieve_t increases the cache's capacity by 25%
+  /// which improves performance by up to 10%.
+  #pragma pack(push, 1)
+  struct sieve_t
+  {
+    uint32_t count;
+    uint64_t bits;
+  };
+  #pragma pack(pop)
+
+  Vector<Vector<sieve_t>> cache;
+};
+
 /// Returns a vector with phi(x, i - 1) values such that
 /// phi[i] = phi(x, i - 1) for 1 <= i <= a.
 /// phi(x, a) counts the numbers <= x that are not
@@ -36,6 +57,24 @@ Vector<int64_t> phi_vector(int64_t x,
                            const Vector<int64_t>& primes,
                            const PiTable& pi);
 
+/// Same as above but phi(x, i - 1) values are stored into
+/// phi (whose capacity is reused) and the memory of the
+/// cache of phi(x, i) results is taken from the arena.
+///
+void phi_vector(int64_t x,
+                int64_t a,
+                const Vector<uint32_t>& primes,
+                const PiTable& pi,
+                Vector<int64_t>& phi,
+                PhiVectorArena& arena);
+
+void phi_vector(int64_t x,
+                int64_t a,
+                const Vector<int64_t>& primes,
+                const PiTable& pi,
+                Vector<int64_t>& phi,
+                PhiVectorArena& arena);
+
 } // namespace
 
 #endif
@@ -0,0 +1,199 @@
+///
+/// @file  pi_verify.hpp
+/// @brief The formulas of Xavier Gourdon's algorithm and of the
+///        Deleglise-Rivat algorithm used by pi_verify.cpp
+///        (--verify option). If the results of both algorithms
+///        differ, find_bad_formulas() recomputes the formulas in
+///        order to find the formulas that are not reproducible.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef PI_VERIFY_HPP
+#define PI_VERIFY_HPP
+
+#include <primecount-internal.hpp>
+#include <gourdon.hpp>
+#include <PhiTiny.hpp>
+#include <S.hpp>
+
+#include <stdint.h>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace primecount {
+
+template <typename T>
+struct GourdonFormulas
+{
+  T sigma = 0;
+  T phi0 = 0;
+  T ac = 0;
+  T d = 0;
+};
+
+template <typename T>
+struct DelegliseRivatFormulas
+{
+  T s1 = 0;
+  T s2_trivial = 0;
+  T s2_easy = 0;
+  T s2_hard = 0;
+};
+
+/// Compute the formulas of Xavier Gourdon's
+/// algorithm, except B(x, y) which is shared.
+///
+template <typename T>
+GourdonFormulas<T> gourdon(T x,
+                           int64_t y,
+                           int64_t z,
+                           int64_t k,
+                           T b,
+                           int threads,
+                           bool is_compact)
+{
+  GourdonFormulas<T> res;
+  res.sigma = Sigma(x, y, threads, false, is_compact);
+  res.phi0 = Phi0(x, y, z, k, threads, false);
+  res.ac = AC(x, y, z, k, threads, false, is_compact);
+  T d_approx = D_approx(x, res.sigma, res.phi0, res.ac, b);
+  res.d = D(x, y, z, k, d_approx, threads, false, is_compact);
+  return res;
+}
+
+/// Compute the formulas of the Deleglise-Rivat
+/// algorithm, except P2(x, y) which is computed
+/// from Gourdon's B(x, y).
+///
+template <typename T>
+DelegliseRivatFormulas<T> deleglise_rivat(T x,
+                                          int64_t y,
+                                          int64_t pi_y,
+                                          T p2,
+                                          int threads,
+                                          bool is_compact)
+{
+  DelegliseRivatFormulas<T> res;
+  int64_t z = (int64_t) (x / y);
+  int64_t c = PhiTiny::get_c(y);
+  res.s1 = S1(x, y, c, threads, false);
+  T s2_approx = S2_approx(x, pi_y, p2, res.s1);
+  res.s2_trivial = S2_trivial(x, y, z, c, threads, false, is_compact);
+  res.s2_easy = S2_easy(x, y, z, c, threads, false, is_compact);
+  T s2_hard_approx = s2_approx - (res.s2_trivial + res.s2_easy);
+  res.s2_hard = S2_hard(x, y, z, c, s2_hard_approx, threads, false, is_compact);
+  return res;
+}
+
+/// Compute both algorithms concurrently, the Deleglise-Rivat
+/// formulas are computed in a background thread. If
+/// threads_dr = 0 (i.e. when using a single thread) both
+/// algorithms are computed one after the other.
+///
+template <typename T>
+void compute_formulas(T x,
+                      int64_t y,
+                      int64_t z,
+                      int64_t k,
+                      int64_t pi_y,
+                      T b,
+                      T p2,
+                      int threads_gourdon,
+                      int threads_dr,
+                      bool is_compact,
+                      GourdonFormulas<T>& g,
+                      DelegliseRivatFormulas<T>& dr)
+{
+  if (threads_dr == 0)
+  {
+    g = gourdon(x, y, z, k, b, threads_gourdon, is_compact);
+    dr = deleglise_rivat(x, y, pi_y, p2, threads_gourdon, is_compact);
+    return;
+  }
+
+  std::string error;
+
+  std::thread thread([&]()
+  {
+    try {
+      dr = deleglise_rivat(x, y, pi_y, p2, threads_dr, is_compact);
+    }
+    catch (std::exception& e) {
+      error = e.what();
+    }
+  });
+
+  try {
+    g = gourdon(x, y, z, k, b, threads_gourdon, is_compact);
+  }
+  catch (std::exception&) {
+    thread.join();
+    throw;
+  }
+
+  thread.join();
+
+  if (!error.empty())
+    throw primecount_error(error);
+}
+
+/// Recompute the independent formulas using a different
+/// number of threads and return the formulas whose
+/// results are not reproducible.
+///
+template <typename T>
+std::string find_bad_formulas(T x,
+                              int64_t y,
+                              int64_t z,
+                              int64_t k,
+                              int64_t pi_y,
+                              T b,
+                              T p2,
+                              int threads_gourdon,
+                              int threads_dr,
+                              bool is_compact,
+                              const GourdonFormulas<T>& g1,
+                              const DelegliseRivatFormulas<T>& dr1)
+{
+  // Swap the threads of both algorithms
+  if (threads_dr > 0)
+    std::swap(threads_gourdon, threads_dr);
+
+  GourdonFormulas<T> g2;
+  DelegliseRivatFormulas<T> dr2;
+  compute_formulas(x, y, z, k, pi_y, b, p2, threads_gourdon, threads_dr, is_compact, g2, dr2);
+
+  std::ostringstream oss;
+  auto check = [&](const char* name, T res1, T res2)
+  {
+    if (res1 != res2)
+      oss << "\n" << name << " is not reproducible: " << res1 << " != " << res2;
+  };
+
+  check("Sigma", g1.sigma, g2.sigma);
+  check("Phi0", g1.phi0, g2.phi0);
+  check("A + C", g1.ac, g2.ac);
+  check("D", g1.d, g2.d);
+  check("S1", dr1.s1, dr2.s1);
+  check("S2_trivial", dr1.s2_trivial, dr2.s2_trivial);
+  check("S2_easy", dr1.s2_easy, dr2.s2_easy);
+  check("S2_hard", dr1.s2_hard, dr2.s2_hard);
+
+  std::string str = oss.str();
+  if (str.empty())
+    str = "\nThe mismatch is reproducible, "
+          "this is a bug in primecount!";
+
+  return str;
+}
+
+} // namespace
+
+#endif
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace primecount {
 
@@ -34,10 +35,16 @@ int64_t pi_primesieve(int64_t x);
 
 std::string pi(const std::string& x, int threads);
 int64_t pi(int64_t x, int threads);
+int64_t pi(int64_t low, int64_t high, int threads);
+std::string pi(const std::string& low, const std::string& high, int threads);
 int64_t pi_noprint(int64_t x, int threads);
 int64_t pi_deleglise_rivat(int64_t x, int threads);
 int64_t nth_prime(int64_t n, int threads);
+std::string nth_prime(const std::string& n, int threads);
+std::vector<int64_t> nth_prime_batch(const std::vector<int64_t>& n, int threads);
+std::vector<std::pair<maxint_t, maxint_t>> get_pi_anchors();
 
+int64_t pi_anchor(int64_t x, int threads, bool print = is_print());
 int64_t pi_cache(int64_t x, bool print = is_print());
 int64_t pi_deleglise_rivat_64(int64_t x, int threads, bool print = is_print());
 int64_t pi_legendre(int64_t x, int threads, bool print = is_print());
@@ -45,6 +52,7 @@ int64_t pi_lehmer(int64_t x, int threads, bool print = is_print());
 int64_t pi_lmo5(int64_t x, bool print = is_print());
 int64_t pi_lmo_parallel(int64_t x, int threads, bool print = is_print());
 int64_t pi_meissel(int64_t x, int threads, bool print = is_print());
+int64_t pi_verify_64(int64_t x, int threads, bool print = is_print());
 int64_t phi(int64_t x, int64_t a, int threads, bool print = is_print());
 int64_t P2(int64_t x, int64_t y, int64_t a, int threads, bool print = is_print());
 int64_t P3(int64_t x, int64_t y, int64_t a, int threads, bool print = is_print());
@@ -57,8 +65,13 @@ int64_t RiemannR_inverse(int64_t);
 #ifdef HAVE_INT128_T
   int128_t pi(int128_t x);
   int128_t pi(int128_t x, int threads);
+  int128_t pi(int128_t low, int128_t high, int threads);
   int128_t pi_deleglise_rivat(int128_t x, int threads);
+  int128_t nth_prime(int128_t n, int threads);
+  int128_t pi_anchor(int128_t x, int threads, bool print = is_print());
   int128_t pi_deleglise_rivat_128(int128_t x, int threads, bool print = is_print());
+  int128_t pi_lmo_parallel_128(int128_t x, int threads, bool print = is_print(), bool is_factor32 = false);
+  int128_t pi_verify_128(int128_t x, int threads, bool print = is_print());
   int128_t P2(int128_t x, int64_t y, int64_t a, int threads, bool print = is_print());
 
   int128_t Li(int128_t);
@@ -69,6 +82,8 @@ int64_t RiemannR_inverse(int64_t);
 
 void set_status_precision(int precision);
 int get_status_precision(maxint_t x);
+void set_contiguous_work(bool is_contiguous);
+bool is_contiguous_work();
 void set_alpha(double alpha);
 void set_alpha_y(double alpha_y);
 void set_alpha_z(double alpha_z);
@@ -78,10 +93,27 @@ double get_alpha_z(int64_t y, int64_t z);
 double get_alpha_lmo(maxint_t x);
 double get_alpha_deleglise_rivat(maxint_t x);
 std::pair<double, double> get_alpha_gourdon(maxint_t x);
+std::pair<int64_t, int64_t> get_yz_gourdon(maxint_t x, double alpha_y, double alpha_z);
 int64_t get_x_star_gourdon(maxint_t x, int64_t y);
 maxint_t get_max_x(double alpha_y);
 maxint_t to_maxint(const std::string& expr);
 double get_time();
+double pi_cost(maxint_t x);
+double sieve_cost(maxint_t low, maxint_t high);
+
+void set_max_memory(double bytes);
+double get_max_memory();
+double PiTable_bytes(int64_t n, bool is_compact);
+double memory_usage_gourdon(maxint_t x, int64_t y, int64_t z, int threads, bool is_compact = false);
+double memory_usage_deleglise_rivat(maxint_t x, int64_t y, int threads, bool is_compact = false);
+void fit_max_memory_gourdon(maxint_t x, double& alpha_y, double& alpha_z);
+void fit_max_memory_deleglise_rivat(maxint_t x, double& alpha);
+bool is_compact_pi_table_gourdon(maxint_t x, int64_t y, int64_t z, int threads);
+bool is_compact_pi_table_deleglise_rivat(maxint_t x, int64_t y, int threads);
+int max_memory_threads_gourdon(maxint_t x, int64_t y, int64_t z, int threads, bool is_compact);
+int max_memory_threads_deleglise_rivat(maxint_t x, int64_t y, int threads, bool is_compact);
+void print_memory_usage_gourdon(maxint_t x, int threads);
+void print_memory_usage_deleglise_rivat(maxint_t x, int threads);
 
 } // namespace primecount
 
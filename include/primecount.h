@@ -54,6 +54,31 @@ int64_t primecount_pi(int64_t x);
  */
 int primecount_pi_str(const char* x, char* res, size_t len);
 
+/*
+ * Count the number of primes inside the interval [low, high].
+ * If the interval is small the primes are counted using the
+ * segmented sieve of Eratosthenes, else pi(high) - pi(low - 1)
+ * is computed using Xavier Gourdon's algorithm.
+ * Returns -1 if an error occurs.
+ */
+int64_t primecount_pi_interval(int64_t low, int64_t high);
+
+/*
+ * 128-bit prime counting function.
+ * Count the number of primes inside the interval [low, high].
+ * 
+ * @param low  Null-terminated string integer e.g. "12345".
+ * @param high Null-terminated string integer e.g. "12345".
+ *             Note that high must be <= primecount_get_max_x().
+ * @param res  Result output buffer.
+ * @param len  Length of the res buffer. The length must be sufficiently
+ *             large to fit the result, 32 is always enough.
+ * @return     Returns -1 if an error occurs, else returns the number
+ *             of characters (>= 1) that have been written to the
+ *             res buffer, not counting the terminating null character.
+ */
+int primecount_pi_interval_str(const char* low, const char* high, char* res, size_t len);
+
 /*
  * Partial sieve function (a.k.a. Legendre-sum).
  * phi(x, a) counts the numbers <= x that are not divisible
@@ -73,6 +98,25 @@ int64_t primecount_phi(int64_t x, int64_t a);
  */
 int64_t primecount_nth_prime(int64_t n);
 
+/*
+ * 128-bit nth prime function.
+ * Find the nth prime using a combination of the prime counting
+ * function and the sieve of Eratosthenes.
+ * 
+ * @param n    Null-terminated string integer e.g. "12345".
+ *             Note that the nth prime must be <= primecount_get_max_x().
+ * @param res  Result output buffer.
+ * @param len  Length of the res buffer. The length must be sufficiently
+ *             large to fit the result, 32 is always enough.
+ * @return     Returns -1 if an error occurs, else returns the number
+ *             of characters (>= 1) that have been written to the
+ *             res buffer, not counting the terminating null character.
+ * 
+ * Run time: O(x^(2/3) / (log x)^2)
+ * Memory usage: O(x^(1/2))
+ */
+int primecount_nth_prime_str(const char* n, char* res, size_t len);
+
 /*
  * Largest number supported by primecount_pi_str(x).
  * @return 64-bit CPUs: 10^31,
@@ -88,6 +132,20 @@ int primecount_get_num_threads(void);
 /*  Set the number of threads */
 void primecount_set_num_threads(int num_threads);
 
+/*
+ * Enable the result cache which memoizes the results of
+ * pi(x), nth_prime(n) and phi(x, a) for large x in memory.
+ * size = 0 disables the result cache (default).
+ */
+void primecount_set_result_cache_size(int64_t size);
+
+/*
+ * Append the results of the result cache to the file path and
+ * load the results of previous processes from that file.
+ * Returns -1 if an error occurs, else 0.
+ */
+int primecount_set_result_cache_file(const char* path);
+
 /* Get the primecount version number, in the form “i.j” */
 const char* primecount_version(void);
 
@@ -13,8 +13,11 @@
 #ifndef PRIMECOUNT_HPP
 #define PRIMECOUNT_HPP
 
+#include <functional>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <vector>
 #include <stdint.h>
 
 #define PRIMECOUNT_VERSION "7.15"
@@ -54,6 +57,24 @@ int64_t pi(int64_t x);
 ///
 std::string pi(const std::string& x);
 
+/// Count the number of primes inside the interval [low, high].
+/// If the interval is small the primes are counted using the
+/// segmented sieve of Eratosthenes, else pi(high) - pi(low - 1)
+/// is computed using Xavier Gourdon's algorithm.
+/// Uses all CPU cores by default.
+/// Throws a primecount_error if an error occurs.
+///
+int64_t pi(int64_t low, int64_t high);
+
+/// 128-bit prime counting function.
+/// Count the number of primes inside the interval [low, high].
+///
+/// @param low, high Null-terminated string integers e.g. "12345".
+///          Note that high must be <= get_max_x().
+/// Throws a primecount_error if an error occurs.
+///
+std::string pi(const std::string& low, const std::string& high);
+
 /// Partial sieve function (a.k.a. Legendre-sum).
 /// phi(x, a) counts the numbers <= x that are not divisible
 /// by any of the first a primes.
@@ -71,6 +92,125 @@ int64_t phi(int64_t x, int64_t a);
 ///
 int64_t nth_prime(int64_t n);
 
+/// 128-bit nth prime function.
+/// Find the nth prime using a combination of the prime counting
+/// function and the sieve of Eratosthenes.
+///
+/// @param n Null-terminated string integer e.g. "12345".
+///          Note that the nth prime must be <= get_max_x().
+/// Throws a primecount_error if an error occurs.
+///
+/// Run time: O(x^(2/3) / (log x)^2)
+/// Memory usage: O(x^(1/2))
+///
+std::string nth_prime(const std::string& n);
+
+/// Find the nth prime for each n of the input vector, the
+/// nth primes are returned in the same order as the input.
+/// This is much faster than calling nth_prime(n) for each n if
+/// many n are close to each other, as the primes between
+/// nearby nth primes are sieved instead of calling pi(x).
+/// @pre n[i] <= 216289611853439384
+/// Throws a primecount_error if an error occurs.
+///
+std::vector<int64_t> nth_prime_batch(const std::vector<int64_t>& n);
+
+/// Options of pi_async() and nth_prime_async()
+struct AsyncOptions
+{
+  /// Number of threads, by default all CPU cores are used
+  int threads = 0;
+
+  /// Called with the progress (in percent) of the formula
+  /// that is currently being computed (at most 10 times per
+  /// second). The callback is run by one of primecount's
+  /// worker threads, it must return quickly.
+  std::function<void(double percent)> progress;
+};
+
+/// Handle of an asynchronous computation started using
+/// pi_async() or nth_prime_async(). Destroying the handle
+/// of a running computation cancels the computation and
+/// waits until it has stopped.
+///
+class AsyncResult
+{
+public:
+  AsyncResult(AsyncResult&&) noexcept;
+  AsyncResult& operator=(AsyncResult&&) noexcept;
+  ~AsyncResult();
+
+  /// Wait until the computation has finished and return its
+  /// result. Throws a primecount_error if the computation
+  /// has been cancelled or if an error occurred.
+  ///
+  std::string wait();
+
+  /// Returns true if the computation has finished
+  bool poll() const;
+
+  /// Request cancellation of the computation and return
+  /// immediately. The computation stops when its threads
+  /// request new work or at the latest before the next
+  /// formula, use wait() to wait until it has stopped.
+  ///
+  void cancel();
+
+  /// Progress (in percent) of the current formula
+  double percent() const;
+
+private:
+  struct State;
+  AsyncResult();
+  static AsyncResult start(const std::function<std::string(int)>& compute,
+                           const AsyncOptions& options);
+  friend AsyncResult pi_async(const std::string&, const AsyncOptions&);
+  friend AsyncResult nth_prime_async(const std::string&, const AsyncOptions&);
+  std::unique_ptr<State> state_;
+};
+
+/// Count the number of primes <= x in a background thread.
+/// @param x Null-terminated string integer e.g. "12345".
+///          Note that x must be <= get_max_x().
+///
+AsyncResult pi_async(const std::string& x,
+                     const AsyncOptions& options = AsyncOptions());
+
+/// Find the nth prime in a background thread.
+/// @param n Null-terminated string integer e.g. "12345".
+///
+AsyncResult nth_prime_async(const std::string& n,
+                            const AsyncOptions& options = AsyncOptions());
+
+/// Result of pi_deadline()
+struct DeadlineResult
+{
+  /// pi(x) if is_exact, else RiemannR(x)
+  std::string pix;
+
+  /// true if pi(x) has been computed before the deadline
+  bool is_exact = false;
+
+  /// If is_exact the run time of the computation in seconds,
+  /// else the predicted run time of the exact computation.
+  double seconds = 0;
+};
+
+/// Count the number of primes <= x using Xavier Gourdon's
+/// algorithm within a time budget of seconds. If the predicted
+/// run time exceeds the budget, the computation is not started
+/// or it is aborted when the deadline is reached and the
+/// RiemannR(x) approximation is returned instead.
+/// The first call calibrates the cost model by computing
+/// pi(10^12), this is not counted against the time budget.
+/// Uses all CPU cores by default.
+///
+/// @param x Null-terminated string integer e.g. "12345".
+///          Note that x must be <= get_max_x().
+/// Throws a primecount_error if an error occurs.
+///
+DeadlineResult pi_deadline(const std::string& x, double seconds);
+
 /// Largest number supported by pi(const std::string& x).
 /// @return 64-bit CPUs: 10^31,
 ///         32-bit CPUs: 2^63-1.
@@ -85,6 +225,24 @@ int get_num_threads();
 /// Set the number of threads
 void set_num_threads(int num_threads);
 
+/// Enable the result cache which memoizes the results of
+/// pi(x), nth_prime(n) and phi(x, a) for large x in memory.
+/// At most size results are kept, the least recently used
+/// results are evicted first. size = 0 disables the result
+/// cache (default). The PRIMECOUNT_RESULT_CACHE_SIZE
+/// environment variable can also be used.
+///
+void set_result_cache_size(int64_t size);
+
+/// Append the results of the result cache to the file path and
+/// load the results of previous processes from that file. This
+/// enables the result cache (if disabled), path = "" stops
+/// writing to the file. The PRIMECOUNT_RESULT_CACHE_FILE
+/// environment variable can also be used.
+/// Throws a primecount_error if the file cannot be opened.
+///
+void set_result_cache_file(const std::string& path);
+
 /// Get the primecount version number, in the form “i.j”
 std::string primecount_version();
 
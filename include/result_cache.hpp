@@ -0,0 +1,69 @@
+///
+/// @file  result_cache.hpp
+/// @brief Opt-in memoization of the results of pi(x), nth_prime(n)
+///        and phi(x, a). The results are stored in memory using a
+///        least recently used (LRU) eviction policy and optionally
+///        in an append-only file which is loaded again by the next
+///        process. See set_result_cache_size() and
+///        set_result_cache_file() in primecount.hpp.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef RESULT_CACHE_HPP
+#define RESULT_CACHE_HPP
+
+#include <int128_t.hpp>
+#include <stdint.h>
+#include <string>
+
+namespace primecount {
+
+enum CachedFunction
+{
+  CACHE_PI,
+  CACHE_NTH_PRIME,
+  CACHE_PHI
+};
+
+/// Small results are computed faster
+/// than they can be looked up.
+///
+constexpr int64_t min_cached_x = (int64_t) 1e10;
+
+bool is_result_cache();
+bool result_cache_find(CachedFunction function, maxint_t x, int64_t a, maxint_t& res);
+void result_cache_insert(CachedFunction function, maxint_t x, int64_t a, maxint_t res);
+bool result_cache_nearest_pi(maxint_t x, maxint_t& cached_x, maxint_t& cached_pix);
+uint64_t result_cache_checksum(const std::string& line);
+
+} // namespace
+
+namespace {
+
+using namespace primecount;
+
+/// Returns the cached result of function(x, a) or
+/// computes it using compute() and caches it.
+///
+template <typename T, typename F>
+T cached_result(CachedFunction function, T x, int64_t a, F compute)
+{
+  if (x < min_cached_x || !is_result_cache())
+    return compute();
+
+  maxint_t res;
+  if (result_cache_find(function, x, a, res))
+    return (T) res;
+
+  T result = compute();
+  result_cache_insert(function, x, a, result);
+  return result;
+}
+
+} // namespace
+
+#endif
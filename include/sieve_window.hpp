@@ -0,0 +1,83 @@
+///
+/// @file  sieve_window.hpp
+/// @brief Segmented sieve of Eratosthenes for small windows
+///        [low, high] with high > 2^64 (i.e. with 128-bit
+///        sieving offsets). primesieve is limited to 2^64.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef SIEVE_WINDOW_HPP
+#define SIEVE_WINDOW_HPP
+
+#include <int128_t.hpp>
+#include <Vector.hpp>
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+namespace primecount {
+
+#ifdef HAVE_INT128_T
+
+/// Sieve of Eratosthenes for windows [low, high] with
+/// high > 2^64, bit i of the sieve array corresponds to the
+/// number low + 2 * i. If keep_primes = true the sieving
+/// primes < 2^32 and the sieve indexes of their next multiples
+/// are kept between windows, hence moving to another window
+/// does not recompute their first multiples (128-bit modulo).
+/// This uses 8 bytes per kept sieving prime (up to 1.6 GiB),
+/// larger sieving primes are not kept.
+///
+class SieveWindow
+{
+public:
+  SieveWindow(int threads, bool keep_primes);
+  void sieve(uint128_t low, int64_t size, Vector<uint64_t>& sieve);
+
+private:
+  void update_primes(uint128_t low, uint64_t size, uint64_t range_size);
+  void add_primes(uint128_t low, uint64_t size, uint64_t range_size, uint64_t stop);
+  void cross_off(Vector<uint64_t>& sieve,
+                 uint64_t size,
+                 int64_t ranges,
+                 uint64_t range_size,
+                 std::size_t small_primes);
+
+  struct SievingPrime
+  {
+    uint64_t prime;
+    uint64_t j;
+  };
+
+  struct KeptPrime
+  {
+    uint32_t prime;
+    uint32_t j;
+  };
+
+  Vector<KeptPrime> kept_;
+  std::vector<std::vector<SievingPrime>> primes_;
+  std::vector<std::vector<std::vector<uint64_t>>> buckets_;
+  uint128_t low_ = 0;
+  uint64_t kept_stop_ = 2;
+  bool keep_primes_;
+  int threads_;
+};
+
+/// Count the primes inside [low, high].
+/// @pre high - low < 2^63 && low > sqrt(high).
+///
+int128_t count_primes_window(uint128_t low,
+                             uint128_t high,
+                             int threads);
+
+#endif
+
+} // namespace
+
+#endif
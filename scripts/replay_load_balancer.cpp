@@ -0,0 +1,654 @@
+// Replay a trace of primecount's load balancers (LoadBalancerS2
+// and LoadBalancerAC) using different load balancing policies
+// and thread counts. The cost of each recorded work interval
+// [low, low + segments * segment_size[ is assumed to be uniformly
+// distributed over the interval, the simulator then computes the
+// run time (makespan) of the policy for any number of threads.
+//
+// 1. Record a trace:
+//    PRIMECOUNT_TRACE_FILE=trace.bin primecount 1e20 --threads=64
+// 2. Compile: c++ -O2 -std=c++11 replay_load_balancer.cpp -o replay
+// 3. List the recorded load balancers:
+//    ./replay trace.bin
+// 4. Simulate a policy:
+//    ./replay trace.bin --run=2 --policy=s2 --threads=256
+//
+// Policies:
+// recorded  The recorded work intervals (in increasing order)
+// fixed     Fixed work intervals of --segments * --segment-size
+// s2        LoadBalancerS2 (default for TRACE_BEGIN_S2)
+// ac        LoadBalancerAC (default for TRACE_BEGIN_AC)
+//
+// Options:
+// --run=N              Simulate only the Nth load balancer
+// --threads=N          Number of simulated threads
+// --policy=NAME        recorded, fixed, s2 or ac
+// --segments=N         Initial number of segments per thread
+// --segment-size=N     Initial segment size
+// --max-segment-size=N Maximum segment size (s2, ac)
+// --lock-us=F          Serialized cost of each get_work() call
+// --init-us=F          Thread initialization cost per work interval
+//                      (default: recorded average)
+// --divider=F          s2: remaining time divider (default 3)
+// --min-factor=F       s2: min. segments change factor (default 0.5)
+// --max-factor=F       s2: max. segments change factor (default 2)
+// --threads-factor=N   ac: min. remaining work intervals per
+//                      thread for increasing the segment size
+//                      (default 8)
+// --min-threshold=F    ac: min. thread run time in seconds below
+//                      which the segment size is increased
+//                      (default 0.01)
+//
+// The TraceRecord struct below must match
+// include/LoadBalancerTrace.hpp.
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+enum TraceType
+{
+  TRACE_BEGIN_S2,
+  TRACE_BEGIN_AC,
+  TRACE_WORK
+};
+
+struct TraceRecord
+{
+  int32_t type;
+  int32_t thread;
+  int64_t low;
+  int64_t segments;
+  int64_t segment_size;
+  double secs;
+  double init_secs;
+  int64_t sum_high;
+  uint64_t sum_low;
+};
+
+static_assert(sizeof(TraceRecord) == 64, "TraceRecord must be 64 bytes");
+
+double to_double(int64_t high, uint64_t low)
+{
+  return std::ldexp((double) high, 64) + (double) low;
+}
+
+/// A recorded load balancer
+struct Run
+{
+  int type = 0;
+  int64_t limit = 0;
+  int threads = 0;
+  int64_t segment_size = 0;
+  double sum = 0;
+  std::vector<TraceRecord> work;
+};
+
+struct Options
+{
+  int run = -1;
+  int threads = 0;
+  std::string policy;
+  int64_t segments = 0;
+  int64_t segment_size = 0;
+  int64_t max_segment_size = 0;
+  double lock_secs = 0;
+  double init_secs = -1;
+  double divider = 3;
+  double min_factor = 0.5;
+  double max_factor = 2;
+  int64_t threads_factor = 8;
+  double min_threshold = 0.01;
+};
+
+/// Cost and sum of the work intervals, the cost and sum
+/// of each recorded interval is uniformly distributed
+/// over the interval.
+///
+class CostModel
+{
+public:
+  CostModel(const Run& run)
+  {
+    std::vector<TraceRecord> work = run.work;
+    std::sort(work.begin(), work.end(),
+      [](const TraceRecord& a, const TraceRecord& b) {
+        return a.low < b.low; });
+
+    double cost = 0;
+    double sum = 0;
+    double init = 0;
+
+    for (const TraceRecord& r : work)
+    {
+      int64_t high = r.low + r.segments * r.segment_size;
+      high = std::min(high, run.limit);
+      if (high <= r.low)
+        continue;
+
+      starts_.push_back(r.low);
+      ends_.push_back(high);
+      cost_.push_back(cost);
+      sum_.push_back(sum);
+      cost += std::max(0.0, r.secs - r.init_secs);
+      sum += to_double(r.sum_high, r.sum_low);
+      init += r.init_secs;
+    }
+
+    total_cost_ = cost;
+    total_sum_ = sum;
+    cost_.push_back(cost);
+    sum_.push_back(sum);
+    if (!work.empty())
+      init_secs_ = init / work.size();
+  }
+
+  double cost(int64_t low, int64_t high) const
+  {
+    return integrate(cost_, high) - integrate(cost_, low);
+  }
+
+  double sum(int64_t low, int64_t high) const
+  {
+    return integrate(sum_, high) - integrate(sum_, low);
+  }
+
+  double total_cost() const { return total_cost_; }
+  double total_sum() const { return total_sum_; }
+  double init_secs() const { return init_secs_; }
+
+private:
+  /// Integral of the density from 0 to x
+  double integrate(const std::vector<double>& prefix, int64_t x) const
+  {
+    if (starts_.empty())
+      return 0;
+
+    auto iter = std::upper_bound(starts_.begin(), starts_.end(), x);
+    if (iter == starts_.begin())
+      return 0;
+
+    std::size_t i = (iter - starts_.begin()) - 1;
+    if (x >= ends_[i])
+      return prefix[i + 1];
+
+    double part = (double) (x - starts_[i]) / (double) (ends_[i] - starts_[i]);
+    return prefix[i] + part * (prefix[i + 1] - prefix[i]);
+  }
+
+  std::vector<int64_t> starts_;
+  std::vector<int64_t> ends_;
+  std::vector<double> cost_;
+  std::vector<double> sum_;
+  double total_cost_ = 0;
+  double total_sum_ = 0;
+  double init_secs_ = 0;
+};
+
+/// State of a simulated thread, same
+/// as ThreadData in LoadBalancerS2.hpp.
+///
+struct ThreadData
+{
+  int64_t low = 0;
+  int64_t segments = 0;
+  int64_t segment_size = 0;
+  double sum = 0;
+  double secs = 0;
+  double init_secs = 0;
+};
+
+class Policy
+{
+public:
+  virtual ~Policy() { }
+  virtual bool get_work(ThreadData& thread, double time) = 0;
+};
+
+class RecordedPolicy : public Policy
+{
+public:
+  RecordedPolicy(const Run& run)
+    : work_(run.work)
+  {
+    std::sort(work_.begin(), work_.end(),
+      [](const TraceRecord& a, const TraceRecord& b) {
+        return a.low < b.low; });
+  }
+
+  bool get_work(ThreadData& thread, double) override
+  {
+    if (i_ >= work_.size())
+      return false;
+
+    thread.low = work_[i_].low;
+    thread.segments = work_[i_].segments;
+    thread.segment_size = work_[i_].segment_size;
+    i_++;
+    return true;
+  }
+
+private:
+  std::vector<TraceRecord> work_;
+  std::size_t i_ = 0;
+};
+
+class FixedPolicy : public Policy
+{
+public:
+  FixedPolicy(const Run& run, const Options& opts)
+    : limit_(run.limit),
+      segments_(std::max<int64_t>(1, opts.segments)),
+      segment_size_(opts.segment_size ? opts.segment_size : run.segment_size)
+  { }
+
+  bool get_work(ThreadData& thread, double) override
+  {
+    thread.low = low_;
+    thread.segments = segments_;
+    thread.segment_size = segment_size_;
+    low_ += segments_ * segment_size_;
+    return thread.low < limit_;
+  }
+
+private:
+  int64_t low_ = 0;
+  int64_t limit_;
+  int64_t segments_;
+  int64_t segment_size_;
+};
+
+double in_between(double min, double x, double max)
+{
+  return std::max(min, std::min(x, max));
+}
+
+double get_percent(double low, double limit)
+{
+  double percent = (100.0 * low) / std::max(1.0, limit);
+  return in_between(0, percent, 100);
+}
+
+/// Copy of skewed_percent() from src/StatusS2.cpp
+double skewed_percent(double x, double y)
+{
+  double p1 = get_percent(x, y);
+  double p2 = p1 * p1;
+  double p3 = p1 * p2;
+  double p4 = p2 * p2;
+
+  double c1 = 3.70559815037356886459;
+  double c2 = 0.07330455122609925077;
+  double c3 = 0.00067895345810494585;
+  double c4 = 0.00000216467760881310;
+
+  double percent = -c4*p4 + c3*p3 - c2*p2 + c1*p1;
+  percent = in_between(0, percent, 100);
+  return percent;
+}
+
+/// Copy of StatusS2::getPercent() from src/StatusS2.cpp
+double s2_percent(double low, double limit, double sum, double sum_approx)
+{
+  double p1 = skewed_percent(sum, sum_approx);
+  double p2 = skewed_percent(low, limit);
+
+  if (p2 > p1)
+    return p2;
+
+  double c1 = 150 / std::max(p1, 1.0);
+  c1 = in_between(10, c1, 4);
+  double c2 = 10 - c1;
+  double percent = (c1*p1 + c2*p2) / 10;
+
+  return percent;
+}
+
+/// Simulation of LoadBalancerS2 (src/LoadBalancerS2.cpp)
+class S2Policy : public Policy
+{
+public:
+  S2Policy(const Run& run, const Options& opts)
+    : opts_(opts),
+      limit_(run.limit),
+      sum_approx_(run.sum)
+  {
+    segments_ = std::max<int64_t>(1, opts.segments);
+    segment_size_ = opts.segment_size ? opts.segment_size : run.segment_size;
+    int64_t sqrt_limit = (int64_t) std::sqrt((double) limit_);
+    max_size_ = opts.max_segment_size;
+    if (!max_size_)
+      max_size_ = std::max<int64_t>((32 << 10) * 2 * 30, sqrt_limit);
+    max_size_ = std::max(max_size_, segment_size_);
+  }
+
+  bool get_work(ThreadData& thread, double time) override
+  {
+    sum_ += thread.sum;
+    time_ = time;
+
+    if (thread.low > max_low_)
+    {
+      max_low_ = thread.low;
+      segments_ = thread.segments;
+
+      if (sum_ != 0)
+      {
+        if (segment_size_ < max_size_)
+        {
+          segment_size_ += segment_size_ / 16;
+          segment_size_ = std::min(segment_size_, max_size_);
+          segment_size_ += (240 - segment_size_ % 240) % 240;
+        }
+        else
+          update_number_of_segments(thread);
+      }
+    }
+
+    thread.low = low_;
+    thread.segments = segments_;
+    thread.segment_size = segment_size_;
+    low_ += segments_ * segment_size_;
+    return thread.low < limit_;
+  }
+
+private:
+  void update_number_of_segments(const ThreadData& thread)
+  {
+    double percent = s2_percent((double) low_, (double) limit_, sum_, sum_approx_);
+    percent = in_between(10, percent, 100);
+    double rem_secs = (time_ * (100 / percent) - time_) / opts_.divider;
+
+    double min_secs = 0.001;
+    double divider = std::max(min_secs, thread.secs);
+    double factor = rem_secs / divider;
+
+    double init_secs = std::max(min_secs, thread.init_secs);
+    double init_factor = in_between(200, (3600 * 6) / init_secs, 5000);
+
+    if (thread.secs > min_secs &&
+        thread.secs > thread.init_secs * init_factor)
+    {
+      double old = factor;
+      double next_runtime = thread.init_secs * init_factor;
+      factor = std::min(next_runtime / thread.secs, old);
+    }
+
+    if (thread.secs > 0 &&
+        thread.secs * factor < thread.init_secs * 20)
+      factor = thread.init_secs * 20 / thread.secs;
+
+    factor = in_between(opts_.min_factor, factor, opts_.max_factor);
+    double next_runtime = thread.secs * factor;
+
+    if (next_runtime < min_secs)
+      segments_ *= 2;
+    else
+    {
+      segments_ = (int64_t) std::round(segments_ * factor);
+      segments_ = std::max<int64_t>(segments_, 1);
+    }
+  }
+
+  Options opts_;
+  int64_t low_ = 0;
+  int64_t max_low_ = 0;
+  int64_t limit_;
+  int64_t segments_ = 1;
+  int64_t segment_size_ = 0;
+  int64_t max_size_ = 0;
+  double sum_ = 0;
+  double sum_approx_;
+  double time_ = 0;
+};
+
+/// Simulation of LoadBalancerAC (src/gourdon/LoadBalancerAC.cpp)
+class ACPolicy : public Policy
+{
+public:
+  ACPolicy(const Run& run, const Options& opts)
+    : opts_(opts),
+      sqrtx_(run.limit),
+      y_((int64_t) run.sum),
+      threads_(opts.threads)
+  {
+    segments_ = std::max<int64_t>(1, opts.segments);
+    segment_size_ = opts.segment_size ? opts.segment_size : run.segment_size;
+    max_segment_size_ = opts.max_segment_size;
+    if (!max_segment_size_)
+      max_segment_size_ = (1 << 20) * 30;
+    max_segment_size_ = std::max(max_segment_size_, segment_size_);
+  }
+
+  bool get_work(ThreadData& thread, double time) override
+  {
+    if (low_ >= sqrtx_)
+      return false;
+
+    int64_t remaining_dist = sqrtx_ - low_;
+    double increase_threshold = std::max(opts_.min_threshold, time / 1000);
+
+    if (segment_size_ == max_segment_size_)
+      increase_threshold = std::min(increase_threshold, 1.0);
+
+    if (low_ > y_ &&
+        thread.secs < increase_threshold &&
+        thread.segments == segments_ &&
+        thread.segment_size == segment_size_ &&
+        segments_ * segment_size_ * (threads_ * opts_.threads_factor) < remaining_dist)
+    {
+      if (segment_size_ >= max_segment_size_)
+        segments_ *= 2;
+      else
+        segment_size_ = std::min(segment_size_ * 2, max_segment_size_);
+    }
+
+    thread.low = low_;
+    thread.segments = segments_;
+    thread.segment_size = segment_size_;
+    low_ = std::min(low_ + segments_ * segment_size_, sqrtx_);
+    return true;
+  }
+
+private:
+  Options opts_;
+  int64_t low_ = 0;
+  int64_t sqrtx_;
+  int64_t y_;
+  int64_t segments_ = 1;
+  int64_t segment_size_ = 0;
+  int64_t max_segment_size_ = 0;
+  int threads_;
+};
+
+struct Result
+{
+  double makespan = 0;
+  double busy = 0;
+  int64_t work_items = 0;
+};
+
+/// Event driven simulation: the thread that finishes
+/// first requests the next work interval.
+///
+Result simulate(const Run& run, const CostModel& model, Policy& policy, const Options& opts)
+{
+  using Event = std::pair<double, int>;
+  std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+  std::vector<ThreadData> threads(opts.threads);
+  double init_secs = (opts.init_secs >= 0) ? opts.init_secs : model.init_secs();
+  double lock_free = 0;
+  Result res;
+
+  for (int i = 0; i < opts.threads; i++)
+    events.push(Event(0.0, i));
+
+  while (!events.empty())
+  {
+    double time = events.top().first;
+    int i = events.top().second;
+    events.pop();
+
+    // get_work() calls are serialized
+    time = std::max(time, lock_free) + opts.lock_secs;
+    lock_free = time;
+    res.makespan = std::max(res.makespan, time);
+
+    ThreadData& thread = threads[i];
+    if (!policy.get_work(thread, time))
+      continue;
+
+    int64_t high = thread.low + thread.segments * thread.segment_size;
+    high = std::min(high, run.limit);
+    double secs = init_secs + model.cost(thread.low, high);
+
+    thread.sum = model.sum(thread.low, high);
+    thread.secs = secs;
+    thread.init_secs = init_secs;
+    res.busy += secs;
+    res.work_items++;
+    events.push(Event(time + secs, i));
+  }
+
+  return res;
+}
+
+std::vector<Run> read_trace(const std::string& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    throw std::runtime_error("failed to open " + path);
+
+  char magic[8];
+  if (!file.read(magic, 8) || std::memcmp(magic, "PCTRACE1", 8) != 0)
+    throw std::runtime_error(path + " is not a primecount trace file");
+
+  std::vector<Run> runs;
+  TraceRecord r;
+
+  while (file.read((char*) &r, sizeof(r)))
+  {
+    if (r.type == TRACE_BEGIN_S2 ||
+        r.type == TRACE_BEGIN_AC)
+    {
+      Run run;
+      run.type = r.type;
+      run.limit = r.low;
+      run.threads = (int) r.segments;
+      run.segment_size = r.segment_size;
+      run.sum = to_double(r.sum_high, r.sum_low);
+      runs.push_back(run);
+    }
+    else if (r.type == TRACE_WORK && !runs.empty())
+      runs.back().work.push_back(r);
+  }
+
+  return runs;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " TRACE [OPTION]..." << std::endl;
+    return 1;
+  }
+
+  Options opts;
+
+  for (int i = 2; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    std::size_t pos = arg.find('=');
+    std::string opt = arg.substr(0, pos);
+    std::string val = (pos != std::string::npos) ? arg.substr(pos + 1) : "";
+
+    if (opt == "--run") opts.run = std::stoi(val);
+    else if (opt == "--threads") opts.threads = std::stoi(val);
+    else if (opt == "--policy") opts.policy = val;
+    else if (opt == "--segments") opts.segments = std::stoll(val);
+    else if (opt == "--segment-size") opts.segment_size = std::stoll(val);
+    else if (opt == "--max-segment-size") opts.max_segment_size = std::stoll(val);
+    else if (opt == "--lock-us") opts.lock_secs = std::stod(val) / 1e6;
+    else if (opt == "--init-us") opts.init_secs = std::stod(val) / 1e6;
+    else if (opt == "--divider") opts.divider = std::stod(val);
+    else if (opt == "--min-factor") opts.min_factor = std::stod(val);
+    else if (opt == "--max-factor") opts.max_factor = std::stod(val);
+    else if (opt == "--threads-factor") opts.threads_factor = std::stoll(val);
+    else if (opt == "--min-threshold") opts.min_threshold = std::stod(val);
+    else
+    {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return 1;
+    }
+  }
+
+  try
+  {
+    std::vector<Run> runs = read_trace(argv[1]);
+
+    for (std::size_t i = 0; i < runs.size(); i++)
+    {
+      const Run& run = runs[i];
+      if (opts.run >= 0 && (std::size_t) opts.run != i)
+        continue;
+
+      CostModel model(run);
+      const char* name = (run.type == TRACE_BEGIN_S2) ? "LoadBalancerS2" : "LoadBalancerAC";
+      std::cout << "Run " << i << ": " << name
+                << ", limit = " << run.limit
+                << ", threads = " << run.threads
+                << ", work items = " << run.work.size()
+                << ", CPU seconds = " << model.total_cost() << std::endl;
+
+      if (opts.run < 0)
+        continue;
+
+      Options o = opts;
+      if (o.threads <= 0)
+        o.threads = run.threads;
+      if (o.policy.empty())
+        o.policy = (run.type == TRACE_BEGIN_S2) ? "s2" : "ac";
+
+      std::unique_ptr<Policy> policy;
+      if (o.policy == "recorded")
+        policy.reset(new RecordedPolicy(run));
+      else if (o.policy == "fixed")
+        policy.reset(new FixedPolicy(run, o));
+      else if (o.policy == "s2")
+        policy.reset(new S2Policy(run, o));
+      else if (o.policy == "ac")
+        policy.reset(new ACPolicy(run, o));
+      else
+      {
+        std::cerr << "Unknown policy: " << o.policy << std::endl;
+        return 1;
+      }
+
+      Result res = simulate(run, model, *policy, o);
+      double efficiency = 100 * res.busy / std::max(1e-9, res.makespan * o.threads);
+
+      std::cout << "Policy: " << o.policy << std::endl;
+      std::cout << "Threads: " << o.threads << std::endl;
+      std::cout << "Work items: " << res.work_items << std::endl;
+      std::cout << "Makespan: " << res.makespan << " sec" << std::endl;
+      std::cout << "Efficiency: " << efficiency << "%" << std::endl;
+    }
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -32,7 +32,8 @@ LoadBalancerP2::LoadBalancerP2(maxint_t x,
   low_(isqrt(x)),
   sieve_limit_(sieve_limit),
   precision_(get_status_precision(x)),
-  is_print_(is_print)
+  is_print_(is_print),
+  async_(get_async_context())
 {
   low_ = min(low_, sieve_limit_);
   int64_t dist = sieve_limit_ - low_;
@@ -50,6 +51,12 @@ LoadBalancerP2::LoadBalancerP2(maxint_t x,
   int64_t chunks_per_thread = 8;
   thread_dist_ = dist / (threads_ * chunks_per_thread);
   thread_dist_ = max(min_thread_dist_, thread_dist_);
+
+  if (is_print_)
+  {
+    status_low_.store(low_, std::memory_order_relaxed);
+    reporter_.reset(new StatusReporter([this] { print_status(); }));
+  }
 }
 
 int LoadBalancerP2::get_threads() const
@@ -61,7 +68,18 @@ int LoadBalancerP2::get_threads() const
 bool LoadBalancerP2::get_work(int64_t& low, int64_t& high)
 {
   LockGuard lockGuard(lock_);
-  print_status();
+
+  // The status is printed by the reporter thread
+  if (is_print_)
+    status_low_.store(low_, std::memory_order_relaxed);
+
+  // Asynchronous computation (see pi_async.cpp)
+  if (async_)
+  {
+    if (async_->is_cancelled())
+      return false;
+    async_->progress(get_percent(low_, sieve_limit_));
+  }
 
   // Calculate the remaining sieving distance
   low_ = min(low_, sieve_limit_);
@@ -104,23 +122,14 @@ bool LoadBalancerP2::get_work(int64_t& low, int64_t& high)
   return low < sieve_limit_;
 }
 
+/// Called by the status reporter thread
 void LoadBalancerP2::print_status()
 {
-  if (is_print_)
-  {
-    double time = get_time();
-    double old = time_;
-    double threshold = 0.1;
-
-    if ((time - old) >= threshold)
-    {
-      time_ = time;
-      double percent = get_percent(low_, sieve_limit_);
-      std::ostringstream status;
-      status << "\rStatus: " << std::fixed << std::setprecision(precision_) << percent << '%';
-      std::cout << status.str() << std::flush;
-    }
-  }
+  int64_t low = status_low_.load(std::memory_order_relaxed);
+  double percent = get_percent(low, sieve_limit_);
+  std::ostringstream status;
+  status << "\rStatus: " << std::fixed << std::setprecision(precision_) << percent << '%';
+  std::cout << status.str() << std::flush;
 }
 
 } // namespace
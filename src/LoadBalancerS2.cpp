@@ -36,7 +36,10 @@
 #include <imath.hpp>
 #include <int128_t.hpp>
 #include <min.hpp>
+#include <print.hpp>
 
+#include <iomanip>
+#include <sstream>
 #include <stdint.h>
 
 namespace primecount {
@@ -49,8 +52,12 @@ LoadBalancerS2::LoadBalancerS2(maxint_t x,
   sieve_limit_(sieve_limit),
   sum_approx_(sum_approx),
   time_(get_time()),
+  allocations_(get_vector_allocations()),
+  is_contiguous_(is_contiguous_work()),
   is_print_(is_print),
-  status_(x)
+  is_trace_(is_trace()),
+  status_(x),
+  async_(get_async_context())
 {
   lock_.init(threads);
 
@@ -91,6 +98,11 @@ LoadBalancerS2::LoadBalancerS2(maxint_t x,
   int64_t min_size = 1 << 9;
   segment_size_ = max(min_size, segment_size_);
   segment_size_ = Sieve::get_segment_size(segment_size_);
+
+  if (is_trace_)
+    trace_begin(TRACE_BEGIN_S2, sieve_limit, threads, segment_size_, sum_approx);
+  if (is_print_)
+    reporter_.reset(new StatusReporter([this] { print_status(); }));
 }
 
 maxint_t LoadBalancerS2::get_sum() const
@@ -103,28 +115,106 @@ bool LoadBalancerS2::get_work(ThreadData& thread)
   LockGuard lockGuard(lock_);
   sum_ += thread.sum;
 
+  if (thread.segments > 0)
+  {
+    init_secs_ += thread.init_secs;
+    thread_secs_ += thread.secs;
+    work_units_ += 1;
+    carried_units_ += thread.is_carried;
+    if (!thread.is_carried)
+      last_init_secs_ = thread.init_secs;
+  }
+
+  // Optional trace for scripts/replay_load_balancer.cpp
+  if (is_trace_ && thread.segments > 0)
+    trace_work(thread.low, thread.segments, thread.segment_size,
+               thread.secs, thread.init_secs, thread.sum);
+
+  uint64_t dist = thread.segments * thread.segment_size;
+  uint64_t high = thread.low + dist;
+
+  // The status is printed by the reporter thread
   if (is_print_)
   {
-    uint64_t dist = thread.segments * thread.segment_size;
-    uint64_t high = thread.low + dist;
-    status_.print(high, sieve_limit_, sum_, sum_approx_);
+    status_low_.store(high, std::memory_order_relaxed);
+    status_sum_.store((double) sum_, std::memory_order_relaxed);
+  }
+
+  // Asynchronous computation (see pi_async.cpp)
+  if (async_)
+  {
+    if (async_->is_cancelled())
+      return false;
+    async_->progress(status_.getPercent(high, sieve_limit_, sum_, sum_approx_));
   }
 
   update_load_balancing(thread);
 
-  thread.low = low_;
-  thread.segments = segments_;
-  thread.segment_size = segment_size_;
+  if (thread.next_low < thread.next_high)
+  {
+    // Continue with the work interval that
+    // has been reserved for this thread.
+    int64_t dist = thread.next_high - thread.next_low;
+    thread.low = thread.next_low;
+    thread.segments = min(segments_, ceil_div(dist, thread.segment_size));
+    thread.next_low += thread.segments * thread.segment_size;
+  }
+  else
+  {
+    thread.low = low_;
+    thread.segments = segments_;
+    thread.segment_size = segment_size_;
+    low_ += segments_ * segment_size_;
+
+    if (is_contiguous_)
+      reserve_next(thread);
+  }
+
   thread.sum = 0;
   thread.secs = 0;
   thread.init_secs = 0;
+  thread.is_carried = false;
+  thread.is_contiguous = is_contiguous_ &&
+                         thread.low == (int64_t) high;
 
-  low_ += segments_ * segment_size_;
   bool is_work = thread.low < sieve_limit_;
 
   return is_work;
 }
 
+/// Reserve the work interval that follows the thread's
+/// new work interval for the same thread. The thread then
+/// processes the reserved work interval in chunks of the
+/// current number of segments, and for each chunk it can
+/// carry forward its phi[] and sieve instead of recomputing
+/// them using phi_vector(). We only do this once the segment
+/// size has reached its maximum (the sieve cannot be reused
+/// if the segment size changes) and we only reserve as much
+/// work as can be finished well before the computation ends.
+///
+void LoadBalancerS2::reserve_next(ThreadData& thread)
+{
+  if (segment_size_ < max_size_ ||
+      low_ >= sieve_limit_ ||
+      thread.secs <= 0)
+    return;
+
+  // The thread's previous run time is a good
+  // estimate of the run time of each chunk.
+  double rem_secs = remaining_secs() / 3;
+  double chunks = rem_secs / (thread.secs * 2);
+  int64_t max_chunks = 8;
+  int64_t next_chunks = (int64_t) in_between(0, chunks, max_chunks);
+
+  if (next_chunks > 0)
+  {
+    thread.next_low = low_;
+    low_ += next_chunks * segments_ * segment_size_;
+    low_ = min(low_, sieve_limit_);
+    thread.next_high = low_;
+  }
+}
+
 void LoadBalancerS2::update_load_balancing(const ThreadData& thread)
 {
   if (thread.low > max_low_)
@@ -187,7 +277,15 @@ void LoadBalancerS2::update_number_of_segments(const ThreadData& thread)
   // backup frequency. If the thread runtime is > 6 hours
   // we reduce the thread runtime to about 200x the thread
   // initialization time.
-  double init_secs = max(min_secs, thread.init_secs);
+  // The initialization time of threads that have carried
+  // forward their phi[] and sieve is close to 0, hence
+  // for these threads we use the last initialization
+  // time of a thread that had to initialize from scratch.
+  double thread_init_secs = thread.init_secs;
+  if (thread.is_carried)
+    thread_init_secs = last_init_secs_;
+
+  double init_secs = max(min_secs, thread_init_secs);
   double init_factor = in_between(200, (3600 * 6) / init_secs, 5000);
 
   // Reduce the thread runtime if it is much larger than
@@ -196,10 +294,10 @@ void LoadBalancerS2::update_number_of_segments(const ThreadData& thread)
   // sure that the thread runtime is still much larger than
   // the thread initialization time.
   if (thread.secs > min_secs &&
-      thread.secs > thread.init_secs * init_factor)
+      thread.secs > thread_init_secs * init_factor)
   {
     double old = factor;
-    double next_runtime = thread.init_secs * init_factor;
+    double next_runtime = thread_init_secs * init_factor;
     factor = next_runtime / thread.secs;
     factor = min(factor, old);
   }
@@ -211,9 +309,9 @@ void LoadBalancerS2::update_number_of_segments(const ThreadData& thread)
   // and ensures that the thread runtime is always at
   // least 20x the thread initialization time.
   if (thread.secs > 0 &&
-      thread.secs * factor < thread.init_secs * 20)
+      thread.secs * factor < thread_init_secs * 20)
   {
-    double next_runtime = thread.init_secs * 20;
+    double next_runtime = thread_init_secs * 20;
     double current_runtime = thread.secs;
     factor = next_runtime / current_runtime;
   }
@@ -239,6 +337,43 @@ void LoadBalancerS2::update_number_of_segments(const ThreadData& thread)
   }
 }
 
+/// Print the fraction of the threads' run time that
+/// has been spent initializing phi[] and the sieve and
+/// the number of memory allocations of the computation
+/// (if ENABLE_ALLOCATION_STATS is defined).
+///
+void LoadBalancerS2::print_init_time()
+{
+  // Print the final status before our text line
+  if (reporter_)
+    reporter_->stop();
+
+  double percent = 0;
+  if (thread_secs_ > 0)
+    percent = 100.0 * init_secs_ / thread_secs_;
+
+  int64_t carried = 0;
+  if (work_units_ > 0)
+    carried = carried_units_ * 100 / work_units_;
+
+  std::ostringstream out;
+  out << "\rThread init: " << std::fixed << std::setprecision(2)
+      << percent << "% of thread time, " << carried
+      << "% of work intervals carried forward";
+  print(out.str());
+#if defined(ENABLE_ALLOCATION_STATS)
+  print("Allocations", get_vector_allocations() - allocations_);
+#endif
+}
+
+/// Called by the status reporter thread
+void LoadBalancerS2::print_status()
+{
+  int64_t low = status_low_.load(std::memory_order_relaxed);
+  maxint_t sum = (maxint_t) status_sum_.load(std::memory_order_relaxed);
+  status_.print(low, sieve_limit_, sum, sum_approx_);
+}
+
 /// Remaining seconds till finished
 double LoadBalancerS2::remaining_secs() const
 {
@@ -0,0 +1,158 @@
+///
+/// @file  LoadBalancerTrace.cpp
+/// @brief Write the binary trace of the load balancers to the
+///        file PRIMECOUNT_TRACE_FILE. The records are buffered
+///        in memory and appended to the file in large chunks.
+///        See LoadBalancerTrace.hpp for the file format.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <LoadBalancerTrace.hpp>
+#include <primecount.hpp>
+#include <int128_t.hpp>
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+using namespace primecount;
+
+namespace {
+
+class TraceFile
+{
+public:
+  TraceFile()
+  {
+    const char* path = std::getenv("PRIMECOUNT_TRACE_FILE");
+    if (!path || !*path)
+      return;
+
+    file_ = std::fopen(path, "ab");
+    if (!file_)
+      throw primecount_error("failed to open trace file: " + std::string(path));
+
+    // Write the header if the file is new
+    if (std::ftell(file_) == 0)
+      std::fwrite("PCTRACE1", 1, 8, file_);
+  }
+
+  ~TraceFile()
+  {
+    if (file_)
+    {
+      flush();
+      std::fclose(file_);
+    }
+  }
+
+  bool is_open() const
+  {
+    return file_ != nullptr;
+  }
+
+  void write(const TraceRecord& record)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_.push_back(record);
+    if (records_.size() >= (1 << 12))
+      write_records();
+  }
+
+  void flush()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_records();
+    std::fflush(file_);
+  }
+
+private:
+  void write_records()
+  {
+    if (!records_.empty())
+      std::fwrite(records_.data(), sizeof(TraceRecord), records_.size(), file_);
+    records_.clear();
+  }
+
+  FILE* file_ = nullptr;
+  std::mutex mutex_;
+  std::vector<TraceRecord> records_;
+};
+
+TraceFile& trace_file()
+{
+  static TraceFile trace;
+  return trace;
+}
+
+void set_sum(TraceRecord& record, maxint_t sum)
+{
+  record.sum_low = (uint64_t) sum;
+#if defined(HAVE_INT128_T)
+  record.sum_high = (int64_t) (sum >> 64);
+#else
+  record.sum_high = (sum < 0) ? -1 : 0;
+#endif
+}
+
+} // namespace
+
+namespace primecount {
+
+bool is_trace()
+{
+  return trace_file().is_open();
+}
+
+void trace_begin(TraceType type,
+                 int64_t limit,
+                 int threads,
+                 int64_t segment_size,
+                 maxint_t sum)
+{
+  TraceRecord record = {};
+  record.type = type;
+  record.low = limit;
+  record.segments = threads;
+  record.segment_size = segment_size;
+  set_sum(record, sum);
+
+  // Make sure the trace of the previous
+  // load balancer is not lost.
+  trace_file().flush();
+  trace_file().write(record);
+}
+
+void trace_work(int64_t low,
+                int64_t segments,
+                int64_t segment_size,
+                double secs,
+                double init_secs,
+                maxint_t sum)
+{
+  TraceRecord record = {};
+  record.type = TRACE_WORK;
+#ifdef _OPENMP
+  record.thread = omp_get_thread_num();
+#endif
+  record.low = low;
+  record.segments = segments;
+  record.segment_size = segment_size;
+  record.secs = secs;
+  record.init_secs = init_secs;
+  set_sum(record, sum);
+  trace_file().write(record);
+}
+
+} // namespace
@@ -0,0 +1,363 @@
+///
+/// @file  Numa.cpp
+/// @brief NUMA aware placement of the lookup tables and of the
+///        worker threads, see Numa.hpp. If libnuma is available
+///        (HAVE_LIBNUMA) it is used, else on Linux we use the
+///        sched_setaffinity() and mbind() system calls directly
+///        and read the NUMA topology from /sys. All functions
+///        are best effort: if a system call fails (e.g. because
+///        it is not permitted inside a container) the memory and
+///        the threads are simply left where they are.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <Numa.hpp>
+#include <primecount.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#if defined(HAVE_LIBNUMA)
+  #include <numa.h>
+  #include <sched.h>
+#elif defined(__linux__)
+  #include <fstream>
+  #include <sched.h>
+  #include <sys/syscall.h>
+#endif
+
+#if defined(__linux__)
+  #include <unistd.h>
+#endif
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+namespace {
+
+using namespace primecount;
+
+NumaPolicy numa_policy_ = NUMA_DEFAULT;
+bool numa_pin_ = false;
+
+/// NUMA node of the lookup tables that are
+/// currently being constructed by this thread,
+/// -1 means use numa_policy_.
+thread_local int numa_node_ = -1;
+
+#if defined(__linux__)
+
+/// CPU affinity of this thread before
+/// it was pinned by NumaPinThread.
+thread_local cpu_set_t affinity_;
+
+#endif
+
+#if !defined(HAVE_LIBNUMA) && \
+     defined(__linux__)
+
+// From <linux/mempolicy.h>
+const int MPOL_BIND_ = 2;
+const int MPOL_INTERLEAVE_ = 3;
+const unsigned MPOL_MF_MOVE_ = 1 << 1;
+
+/// Parse a Linux cpulist e.g. "0-3,8-11"
+std::vector<int> parse_list(const std::string& str)
+{
+  std::vector<int> list;
+  std::size_t pos = 0;
+
+  while (pos < str.size())
+  {
+    std::size_t end = str.find(',', pos);
+    if (end == std::string::npos)
+      end = str.size();
+
+    std::string range = str.substr(pos, end - pos);
+    std::size_t dash = range.find('-');
+
+    try {
+      if (dash == std::string::npos)
+        list.push_back(std::stoi(range));
+      else
+      {
+        int first = std::stoi(range.substr(0, dash));
+        int last = std::stoi(range.substr(dash + 1));
+        for (int i = first; i <= last; i++)
+          list.push_back(i);
+      }
+    }
+    catch (std::exception&)
+    { }
+
+    pos = end + 1;
+  }
+
+  return list;
+}
+
+std::vector<int> read_list(const std::string& path)
+{
+  std::ifstream file(path);
+  std::string line;
+
+  if (file && std::getline(file, line))
+    return parse_list(line);
+  else
+    return std::vector<int>();
+}
+
+std::vector<int> node_cpus(int node)
+{
+  std::string path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+  return read_list(path);
+}
+
+/// cpu_nodes[cpu] = NUMA node of cpu
+const std::vector<int>& cpu_nodes()
+{
+  static const std::vector<int> cpu_nodes = []
+  {
+    std::vector<int> nodes;
+
+    for (int node = 0; node < numa_nodes(); node++)
+    {
+      for (int cpu : node_cpus(node))
+      {
+        if (cpu >= (int) nodes.size())
+          nodes.resize(cpu + 1, 0);
+        nodes[cpu] = node;
+      }
+    }
+
+    return nodes;
+  }();
+
+  return cpu_nodes;
+}
+
+void mbind_memory(void* ptr, std::size_t bytes, int mode, int node)
+{
+  std::vector<unsigned long> mask;
+  int nodes = numa_nodes();
+  int bits = sizeof(unsigned long) * 8;
+  mask.resize(nodes / bits + 1, 0);
+
+  for (int i = 0; i < nodes; i++)
+    if (node < 0 || i == node)
+      mask[i / bits] |= 1ul << (i % bits);
+
+  unsigned long maxnode = mask.size() * bits;
+  syscall(SYS_mbind, ptr, bytes, mode, mask.data(), maxnode, MPOL_MF_MOVE_);
+}
+
+#endif
+
+} // namespace
+
+namespace primecount {
+
+void set_numa_policy(NumaPolicy policy)
+{
+  numa_policy_ = policy;
+}
+
+void set_numa_policy(const std::string& policy)
+{
+  if (policy == "default")
+    numa_policy_ = NUMA_DEFAULT;
+  else if (policy == "interleave")
+    numa_policy_ = NUMA_INTERLEAVE;
+  else if (policy == "replicate")
+    numa_policy_ = NUMA_REPLICATE;
+  else
+    throw primecount_error("invalid NUMA policy: " + policy);
+}
+
+NumaPolicy get_numa_policy()
+{
+  return numa_policy_;
+}
+
+void set_numa_pin(bool pin)
+{
+  numa_pin_ = pin;
+}
+
+bool is_numa_pin()
+{
+  return numa_pin_;
+}
+
+bool is_numa()
+{
+  return numa_policy_ != NUMA_DEFAULT ||
+         numa_pin_;
+}
+
+std::string numa_policy_str()
+{
+  std::string str;
+
+  switch (numa_policy_)
+  {
+    case NUMA_INTERLEAVE: str = "interleave"; break;
+    case NUMA_REPLICATE:  str = "replicate"; break;
+    default:              str = "default"; break;
+  }
+
+  if (numa_pin_)
+    str += ", pinned threads";
+
+  int nodes = numa_nodes();
+  str += ", " + std::to_string(nodes);
+  str += (nodes == 1) ? " node" : " nodes";
+
+#if defined(HAVE_LIBNUMA)
+  str += " (libnuma)";
+#endif
+
+  return str;
+}
+
+int numa_nodes()
+{
+  static const int nodes = []
+  {
+    int n = 1;
+
+#if defined(HAVE_LIBNUMA)
+    if (numa_available() >= 0)
+      n = numa_max_node() + 1;
+#elif defined(__linux__)
+    std::vector<int> online = read_list("/sys/devices/system/node/online");
+    if (!online.empty())
+      n = *std::max_element(online.begin(), online.end()) + 1;
+#endif
+
+    return std::max(n, 1);
+  }();
+
+  return nodes;
+}
+
+int numa_current_node()
+{
+  if (numa_nodes() <= 1)
+    return 0;
+
+#if defined(HAVE_LIBNUMA)
+  int cpu = sched_getcpu();
+  if (cpu >= 0)
+    return std::max(numa_node_of_cpu(cpu), 0);
+#elif defined(__linux__)
+  int cpu = sched_getcpu();
+  const auto& nodes = cpu_nodes();
+  if (cpu >= 0 && cpu < (int) nodes.size())
+    return nodes[cpu];
+#endif
+
+  return 0;
+}
+
+NumaPinThread::NumaPinThread(int threads)
+{
+  int nodes = numa_nodes();
+  if (!numa_pin_ || nodes <= 1)
+    return;
+
+  int thread = 0;
+#ifdef _OPENMP
+  thread = omp_get_thread_num();
+#endif
+
+  threads = std::max(threads, 1);
+  int node = (int) ((int64_t) thread * nodes / threads);
+  node = std::min(node, nodes - 1);
+
+#if defined(__linux__)
+  if (sched_getaffinity(0, sizeof(affinity_), &affinity_) != 0)
+    return;
+  is_pinned_ = true;
+#endif
+
+#if defined(HAVE_LIBNUMA)
+  numa_run_on_node(node);
+#elif defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : node_cpus(node))
+    if (cpu < CPU_SETSIZE)
+      CPU_SET(cpu, &set);
+  if (CPU_COUNT(&set) > 0)
+    sched_setaffinity(0, sizeof(set), &set);
+#endif
+}
+
+NumaPinThread::~NumaPinThread()
+{
+  if (!is_pinned_)
+    return;
+
+#if defined(__linux__)
+  sched_setaffinity(0, sizeof(affinity_), &affinity_);
+#endif
+}
+
+void numa_place(void* ptr, std::size_t bytes)
+{
+  int node = numa_node_;
+  if (node < 0 && numa_policy_ != NUMA_INTERLEAVE)
+    return;
+
+#if defined(__linux__)
+  // mbind() requires a page aligned address
+  uintptr_t page = (uintptr_t) sysconf(_SC_PAGESIZE);
+  uintptr_t start = (uintptr_t) ptr;
+  uintptr_t stop = start + bytes;
+  start = (start + page - 1) / page * page;
+  stop = stop / page * page;
+  if (stop <= start)
+    return;
+
+  void* addr = (void*) start;
+  std::size_t size = stop - start;
+
+  #if defined(HAVE_LIBNUMA)
+    if (numa_available() < 0)
+      return;
+    if (node >= 0)
+      numa_tonode_memory(addr, size, node);
+    else
+      numa_interleave_memory(addr, size, numa_all_nodes_ptr);
+  #else
+    if (node >= 0)
+      mbind_memory(addr, size, MPOL_BIND_, node);
+    else
+      mbind_memory(addr, size, MPOL_INTERLEAVE_, -1);
+  #endif
+#else
+  (void) ptr;
+  (void) bytes;
+#endif
+}
+
+NumaNode::NumaNode(int node)
+  : previous_(numa_node_)
+{
+  numa_node_ = node;
+}
+
+NumaNode::~NumaNode()
+{
+  numa_node_ = previous_;
+}
+
+} // namespace
@@ -3,7 +3,9 @@
 /// @brief phi_tiny(x, a) counts the numbers <= x that are not
 ///        divisible by any of the first a primes. phi_tiny(x, a)
 ///        computes phi(x, a) in constant time for a <= 8 using
-///        lookup tables and the formula below.
+///        lookup tables and the formula below. If primecount
+///        has been built with ENABLE_PHI_TINY_10 (cmake
+///        -DWITH_PHI_TINY_10=ON) phi_tiny(x, a) supports a <= 10.
 ///
 ///        phi(x, a) = (x / pp) * φ(pp) + phi(x % pp, a)
 ///        with pp = 2 * 3 * ... * prime[a]
@@ -27,6 +29,22 @@
 
 namespace primecount {
 
+#if defined(ENABLE_PHI_TINY_10)
+
+const Array<uint32_t, 9> PhiTiny::primes = { 0, 2, 3, 5, 7, 11, 13, 17, 19 };
+
+// prime_products[n] = \prod_{i=1}^{n} primes[i]
+const Array<uint32_t, 9> PhiTiny::prime_products = { 1, 2, 6, 30, 210, 2310, 30030, 510510, 9699690 };
+
+// totients[n] = \prod_{i=1}^{n} (primes[i] - 1)
+const Array<uint32_t, 9> PhiTiny::totients = { 1, 1, 2, 8, 48, 480, 5760, 92160, 1658880 };
+
+// Number of primes <= 29 = prime[max_a()]
+const Array<uint8_t, 30> PhiTiny::pi = { 0, 0, 1, 2, 2, 3, 3, 4, 4, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 8,
+                                         8, 8, 8, 9, 9, 9, 9, 9, 9, 10 };
+
+#else
+
 const Array<uint32_t, 8> PhiTiny::primes = { 0, 2, 3, 5, 7, 11, 13, 17 };
 
 // prime_products[n] = \prod_{i=1}^{n} primes[i]
@@ -35,17 +53,19 @@ const Array<uint32_t, 8> PhiTiny::prime_products = { 1, 2, 6, 30, 210, 2310, 300
 // totients[n] = \prod_{i=1}^{n} (primes[i] - 1)
 const Array<uint32_t, 8> PhiTiny::totients = { 1, 1, 2, 8, 48, 480, 5760, 92160 };
 
-// Number of primes <= next_prime(primes.back())
+// Number of primes <= 19 = prime[max_a()]
 const Array<uint8_t, 20> PhiTiny::pi = { 0, 0, 1, 2, 2, 3, 3, 4, 4, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 8 };
 
+#endif
+
 // Singleton
 const PhiTiny phiTiny;
 
 PhiTiny::PhiTiny()
 {
   // The pi[x] lookup table must contain the number
-  // of primes <= next_prime(primes.back()).
-  ASSERT(pi.back() == primes.size());
+  // of primes <= prime[max_a()].
+  ASSERT(pi.back() == max_a());
   ASSERT(phi_.size() - 1 == (uint64_t) pi[5]);
   ASSERT(sieve_.size() == primes.size());
   static_assert(prime_products.size() == primes.size(), "Invalid prime_products size!");
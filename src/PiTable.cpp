@@ -20,6 +20,7 @@
 #include <Vector.hpp>
 #include <imath.hpp>
 #include <macros.hpp>
+#include <Numa.hpp>
 #include <min.hpp>
 
 #include <stdint.h>
@@ -105,21 +106,56 @@ const Array<PiTable::pi_t, 128> PiTable::pi_cache_ =
   { 3269, 0x30860982146A41A9ull }, { 3290, 0x5A952B004238A29Cull }
 }};
 
-PiTable::PiTable(uint64_t max_x, int threads) :
+/// The compact layout is used if the default layout exceeds
+/// the user's --max-memory, see is_compact_pi_table_gourdon()
+/// in memory_usage.cpp.
+///
+PiTable::PiTable(uint64_t max_x, int threads, bool is_compact) :
   max_x_(max_x)
 {
-  // Initialize PiTable from cache
   uint64_t limit = max_x + 1;
-  pi_.resize(ceil_div(limit, 240));
-  std::size_t n = min(pi_cache_.size(), pi_.size());
-  std::copy_n(&pi_cache_[0], n, &pi_[0]);
+  uint64_t words = ceil_div(limit, 240);
+
+  if (!is_compact)
+  {
+    pi_.resize(words);
+    numa_place(pi_.data(), pi_.size() * sizeof(pi_t));
+  }
+  else
+  {
+    // Allocate 1 additional block so that
+    // the blocks can be aligned to 64 bytes.
+    uint64_t blocks = ceil_div(words, 7);
+    compact_.resize((blocks + 1) * 8);
+    numa_place(compact_.data(), compact_.size() * sizeof(uint64_t));
+    uintptr_t addr = (uintptr_t) compact_.data();
+    addr = (addr + 63) & ~((uintptr_t) 63);
+    blocks_ = (block_t*) addr;
+    blocks_[blocks - 1] = block_t{};
+  }
+
+  // Initialize PiTable from cache
+  std::size_t n = min(pi_cache_.size(), words);
+  for (std::size_t i = 0; i < n; i++)
+  {
+    bits(i) = pi_cache_[i].bits;
+    set_count(i, pi_cache_[i].count);
+  }
 
   uint64_t cache_limit = pi_cache_.size() * 240;
   if (limit > cache_limit)
     init(limit, cache_limit, threads);
 }
 
-/// Used if PiTable larger than pi_cache
+/// Used if PiTable larger than pi_cache.
+/// The PiTable is constructed in a single streaming pass
+/// using cache sized blocks: each thread first sieves a
+/// block into its private sieve buffer and afterwards it
+/// computes the prime counts of the block and writes the
+/// block into the PiTable. Hence the PiTable memory is only
+/// written once. The prime count at the start of each
+/// block is computed using a parallel (ordered) scan.
+///
 void PiTable::init(uint64_t limit,
                    uint64_t cache_limit,
                    int threads)
@@ -128,48 +164,53 @@ void PiTable::init(uint64_t limit,
   uint64_t dist = limit - cache_limit;
   uint64_t thread_threshold = (uint64_t) 1e7;
   threads = ideal_num_threads(dist, threads, thread_threshold);
-  uint64_t thread_dist = dist / threads;
-  thread_dist = max(thread_threshold, thread_dist);
-  thread_dist += 240 - thread_dist % 240;
-  counts_.resize(threads);
+
+  // 1680 = 7 * 240, the blocks of the compact
+  // layout are never shared by 2 threads.
+  uint64_t block_size = 1680 * (1 << 12);
+  int64_t blocks = ceil_div(limit, block_size);
+
+  // PrimePi(cache_limit - 1)
+  pi_t cache_last = pi_cache_.back();
+  uint64_t count = cache_last.count + popcnt64(cache_last.bits);
 
   #pragma omp parallel num_threads(threads)
   {
-    #pragma omp for
-    for (int t = 0; t < threads; t++)
-    {
-      uint64_t low = cache_limit + thread_dist * t;
-      uint64_t high = low + thread_dist;
-      high = min(high, limit);
+    Vector<uint64_t> sieve(block_size / 240);
 
-      if (low < high)
-        init_bits(low, high, t);
-    }
-
-    #pragma omp for
-    for (int t = 0; t < threads; t++)
+    #pragma omp for ordered schedule(dynamic)
+    for (int64_t b = 0; b < blocks; b++)
     {
-      uint64_t low = cache_limit + thread_dist * t;
-      uint64_t high = low + thread_dist;
-      high = min(high, limit);
-
-      if (low < high)
-        init_count(low, high, t);
+      uint64_t low = max(cache_limit, block_size * b);
+      uint64_t high = min(block_size * (b + 1), limit);
+      uint64_t block_count = init_bits(low, high, sieve);
+      uint64_t start_count = 0;
+
+      #pragma omp ordered
+      {
+        start_count = count;
+        count += block_count;
+      }
+
+      init_count(low, high, sieve, start_count);
     }
   }
 }
 
-/// Each thread computes PrimePi [low, high[
-void PiTable::init_bits(uint64_t low,
-                        uint64_t high,
-                        uint64_t thread_num)
+/// Sieve the primes inside [low, high[ and
+/// return the number of primes. Each bit of
+/// the sieve corresponds to an integer that is
+/// not divisible by 2, 3 and 5.
+///
+uint64_t PiTable::init_bits(uint64_t low,
+                            uint64_t high,
+                            Vector<uint64_t>& sieve)
 {
-  // Zero initialize pi vector
-  uint64_t i = low / 240;
-  uint64_t j = ceil_div(high, 240);
-  std::fill_n(&pi_[i], j - i, pi_t{0, 0});
+  uint64_t words = ceil_div(high, 240) - low / 240;
+  std::fill_n(sieve.data(), words, 0);
 
   // Iterate over primes >= 7
+  uint64_t offset = low - low % 240;
   low = max(low, 7);
   primesieve::iterator it(low, high);
   uint64_t count = 0;
@@ -177,33 +218,31 @@ void PiTable::init_bits(uint64_t low,
 
   while ((prime = it.next_prime()) < high)
   {
-    uint64_t prime_bit = set_bit_[prime % 240];
-    pi_[prime / 240].bits |= prime_bit;
+    uint64_t n = prime - offset;
+    sieve[n / 240] |= set_bit_[n % 240];
     count += 1;
   }
 
-  counts_[thread_num] = count;
+  return count;
 }
 
-/// Each thread computes PrimePi [low, high[
+/// Write the sieve of [low, high[ into the
+/// PiTable, count = PrimePi(low - 1).
+///
 void PiTable::init_count(uint64_t low,
                          uint64_t high,
-                         uint64_t thread_num)
+                         const Vector<uint64_t>& sieve,
+                         uint64_t count)
 {
-  // First compute PrimePi[low - 1]
-  pi_t cache_last = pi_cache_.back();
-  uint64_t count = cache_last.count + popcnt64(cache_last.bits);
-  for (uint64_t i = 0; i < thread_num; i++)
-    count += counts_[i];
-
   // Convert to array indexes
   uint64_t i = low / 240;
   uint64_t stop_idx = ceil_div(high, 240);
 
-  for (; i < stop_idx; i++)
+  for (uint64_t j = 0; i < stop_idx; i++, j++)
   {
-    pi_[i].count = count;
-    count += popcnt64(pi_[i].bits);
+    bits(i) = sieve[j];
+    set_count(i, count);
+    count += popcnt64(sieve[j]);
   }
 }
 
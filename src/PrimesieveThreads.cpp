@@ -0,0 +1,50 @@
+///
+/// @file  PrimesieveThreads.cpp
+/// @brief Set primesieve's number of threads until the end of
+///        the current scope (see PrimesieveThreads.hpp).
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <PrimesieveThreads.hpp>
+#include <primesieve.hpp>
+
+#include <mutex>
+
+namespace {
+
+std::mutex mutex_;
+int objects_ = 0;
+int old_threads_ = 0;
+
+} // namespace
+
+namespace primecount {
+
+/// primesieve's number of threads is only changed if it
+/// differs, hence running many single-threaded computations
+/// in parallel (--batch) does not write to it.
+///
+PrimesieveThreads::PrimesieveThreads(int threads)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (objects_++ == 0)
+    old_threads_ = primesieve::get_num_threads();
+  if (primesieve::get_num_threads() != threads)
+    primesieve::set_num_threads(threads);
+}
+
+PrimesieveThreads::~PrimesieveThreads()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (--objects_ == 0 &&
+      primesieve::get_num_threads() != old_threads_)
+    primesieve::set_num_threads(old_threads_);
+}
+
+} // namespace
@@ -14,7 +14,7 @@
 ///
 
 #include <primecount-internal.hpp>
-#include <PhiTiny.hpp>
+#include <ordinary_leaves.hpp>
 #include <generate_primes.hpp>
 #include <imath.hpp>
 #include <int128_t.hpp>
@@ -28,34 +28,6 @@ using namespace primecount;
 
 namespace {
 
-/// Recursively iterate over the square free numbers coprime
-/// to the first b primes and calculate the sum of the
-/// ordinary leaves. This algorithm is described in section
-/// 2.2 of the paper: Douglas Staple, "The Combinatorial
-/// Algorithm For Computing pi(x)", arXiv:1503.01839, 6 March
-/// 2015.
-///
-template <int MU, typename T, typename vect>
-T S1_thread(T x,
-            int64_t y,
-            uint64_t b,
-            int64_t c,
-            T square_free,
-            const vect& primes)
-{
-  T s1 = 0;
-
-  for (b++; b < primes.size(); b++)
-  {
-    T next = square_free * primes[b];
-    if (next > y) break;
-    s1 += MU * phi_tiny(x / next, c);
-    s1 += S1_thread<-MU>(x, y, b, c, next, primes);
-  }
-
-  return s1;
-}
-
 /// Parallel computation of the ordinary leaves.
 /// Run time: O(y * log(log(y)))
 /// Memory usage: O(y / log(y))
@@ -72,17 +44,10 @@ X S1_OpenMP(X x,
   threads = ideal_num_threads(y, threads, thread_threshold);
 
   auto primes = generate_primes<Y>(y);
-  int64_t pi_y = primes.size() - 1;
-  X s1 = phi_tiny(x, c);
 
-  #pragma omp parallel for schedule(static, 1) num_threads(threads) reduction (+: s1)
-  for (int64_t b = c + 1; b <= pi_y; b++)
-  {
-    s1 -= phi_tiny(x / primes[b], c);
-    s1 += S1_thread<1>(x, y, b, c, (X) primes[b], primes);
-  }
-
-  return s1;
+  // The expensive subtrees of the small primes are split
+  // into many tasks which use dynamic scheduling.
+  return ordinary_leaves_OpenMP(x, (int64_t) y, c, primes, threads);
 }
 
 } // namespace
@@ -269,6 +269,17 @@ const Array<uint64_t, 240> Sieve::unset_larger =
 Sieve::Sieve(uint64_t low,
              uint64_t segment_size, 
              uint64_t wheel_size)
+{
+  init(low, segment_size, wheel_size);
+}
+
+/// Reinitialize the sieve for a new work interval starting
+/// at low. The memory of the sieve array, of the wheel and
+/// of the counter array is reused if it is large enough.
+///
+void Sieve::init(uint64_t low,
+                 uint64_t segment_size,
+                 uint64_t wheel_size)
 {
   ASSERT(low % 30 == 0);
   ASSERT(segment_size % 240 == 0);
@@ -279,7 +290,9 @@ Sieve::Sieve(uint64_t low,
   // sieve_size = segment_size / 30 as each byte corresponds
   // to 30 numbers i.e. the 8 bits correspond to the
   // offsets = {1, 7, 11, 13, 17, 19, 23, 29}.
+  sieve_.clear();
   sieve_.resize(segment_size / 30);
+  wheel_.clear();
   wheel_.reserve(wheel_size);
   wheel_.resize(4);
   allocate_counter(low);
@@ -327,6 +340,7 @@ void Sieve::allocate_counter(uint64_t low)
   // Hence the max(counter value) = 2^18.
   ASSERT(bytes * 8 <= pstd::numeric_limits<uint32_t>::max());
   uint64_t counter_size = ceil_div(sieve_.size(), bytes);
+  counter_.counter.clear();
   counter_.counter.resize(counter_size);
   counter_.dist = bytes * 30;
   counter_.log2_dist = ilog2(bytes);
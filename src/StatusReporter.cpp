@@ -0,0 +1,63 @@
+///
+/// @file  StatusReporter.cpp
+/// @brief Background thread that prints the status of the
+///        load balancers (LoadBalancerS2, LoadBalancerAC and
+///        LoadBalancerP2) outside of their critical sections.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <StatusReporter.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace primecount {
+
+StatusReporter::StatusReporter(const std::function<void()>& print)
+  : print_(print)
+{
+  thread_ = std::thread([this]() { run(); });
+}
+
+StatusReporter::~StatusReporter()
+{
+  stop();
+}
+
+/// Stop the reporter thread and print the final status
+void StatusReporter::stop()
+{
+  if (!thread_.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+
+  cond_.notify_one();
+  thread_.join();
+  print_();
+}
+
+void StatusReporter::run()
+{
+  auto interval = std::chrono::milliseconds(100);
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (!cond_.wait_for(lock, interval, [this] { return stop_; }))
+  {
+    lock.unlock();
+    print_();
+    lock.lock();
+  }
+}
+
+} // namespace
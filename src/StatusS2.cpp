@@ -101,7 +101,7 @@ void StatusS2::print(double percent)
 
 /// This method is used by S2_hard() and D().
 /// This method does not use a lock to synchronize threads
-/// as it is only used inside of a critical section inside
+/// as it is only used by the status reporter thread of
 /// LoadBalancerS2.cpp and hence it can never be accessed
 /// simultaneously from multiple threads.
 ///
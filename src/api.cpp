@@ -11,14 +11,17 @@
 #include <primecount.hpp>
 #include <primecount-internal.hpp>
 #include <primesieve.hpp>
+#include <AsyncContext.hpp>
 #include <gourdon.hpp>
 #include <int128_t.hpp>
 #include <macros.hpp>
 #include <PiTable.hpp>
 #include <print.hpp>
+#include <result_cache.hpp>
 
 #include <cmath>
 #include <string>
+#include <vector>
 #include <stdint.h>
 
 #ifdef _OPENMP
@@ -31,6 +34,56 @@ namespace {
   int threads_ = 0;
 #endif
 
+using namespace primecount;
+
+int64_t pi_uncached(int64_t x, int threads)
+{
+  // Compute pi(x) in O(1) for small values of x
+  if (x <= PiTable::max_cached())
+    return pi_cache(x);
+
+  // For ]10^4, 10^5] Legendre's algorithm runs fastest
+  if (x <= (int64_t) 1e5)
+    return pi_legendre(x, threads);
+
+  // For ]10^5, 10^8] Meissel's algorithm runs fastest
+  if (x <= (int64_t) 1e8)
+    return pi_meissel(x, threads);
+
+  // If x is close to a known pi(x) value (anchor)
+  // we only need to sieve the distance to the anchor.
+  int64_t pix = pi_anchor(x, threads);
+  if (pix >= 0)
+    return pix;
+
+  // For large x Gourdon's algorithm runs fastest
+  return pi_gourdon_64(x, threads);
+}
+
+#ifdef HAVE_INT128_T
+
+/// Requires x > 2^63 - 1
+int128_t pi_uncached(int128_t x, int threads)
+{
+  int128_t pix = pi_anchor(x, threads);
+  if (pix >= 0)
+    return pix;
+  else
+    return pi_gourdon_128(x, threads);
+}
+
+#endif
+
+/// All public pi(x) functions go through pi_cached(),
+/// hence they all look up x in the result cache.
+///
+template <typename T>
+T pi_cached(T x, int threads)
+{
+  return cached_result(CACHE_PI, x, 0, [&] {
+    return pi_uncached(x, threads); });
+}
+
 } // namespace
 
 namespace primecount {
@@ -52,27 +105,28 @@ int64_t pi(int64_t x)
   return pi(x, get_num_threads());
 }
 
-int64_t pi(int64_t x, int threads)
+int64_t pi(int64_t low, int64_t high)
 {
-  // Compute pi(x) in O(1) for small values of x
-  if (x <= PiTable::max_cached())
-    return pi_cache(x);
-
-  // For ]10^4, 10^5] Legendre's algorithm runs fastest
-  if (x <= (int64_t) 1e5)
-    return pi_legendre(x, threads);
+  return pi(low, high, get_num_threads());
+}
 
-  // For ]10^5, 10^8] Meissel's algorithm runs fastest
-  if (x <= (int64_t) 1e8)
-    return pi_meissel(x, threads);
+std::string pi(const std::string& low, const std::string& high)
+{
+  return pi(low, high, get_num_threads());
+}
 
-  // For large x Gourdon's algorithm runs fastest
-  return pi_gourdon_64(x, threads);
+int64_t pi(int64_t x, int threads)
+{
+  return pi_cached(x, threads);
 }
 
 /// Used internally for initialization
 int64_t pi_noprint(int64_t x, int threads)
 {
+  // Nested computation, e.g. inside of B(x, y)'s
+  // parallel region: must neither be cancelled
+  // nor report its progress (see AsyncContext.hpp).
+  AsyncContextGuard guard(nullptr);
   bool is_print = false;
 
   if (x <= PiTable::max_cached())
@@ -81,6 +135,10 @@ int64_t pi_noprint(int64_t x, int threads)
     return pi_legendre(x, threads, is_print);
   else if (x <= (int64_t) 1e8)
     return pi_meissel(x, threads, is_print);
+
+  int64_t pix = pi_anchor(x, threads, is_print);
+  if (pix >= 0)
+    return pix;
   else
     return pi_gourdon_64(x, threads, is_print);
 }
@@ -130,7 +188,7 @@ int128_t pi(int128_t x, int threads)
   if (x <= pstd::numeric_limits<int64_t>::max())
     return pi((int64_t) x, threads);
   else
-    return pi_gourdon_128(x, threads);
+    return pi_cached(x, threads);
 }
 
 int128_t pi_deleglise_rivat(int128_t x, int threads)
@@ -165,12 +223,27 @@ int128_t pi_gourdon(int128_t x, int threads)
 
 int64_t nth_prime(int64_t n)
 {
-  return nth_prime(n, get_num_threads());
+  return cached_result(CACHE_NTH_PRIME, n, 0, [&] {
+    return nth_prime(n, get_num_threads()); });
+}
+
+std::string nth_prime(const std::string& n)
+{
+  maxint_t x = to_maxint(n);
+  maxint_t res = cached_result(CACHE_NTH_PRIME, x, 0, [&] {
+    return to_maxint(nth_prime(n, get_num_threads())); });
+  return to_string(res);
+}
+
+std::vector<int64_t> nth_prime_batch(const std::vector<int64_t>& n)
+{
+  return nth_prime_batch(n, get_num_threads());
 }
 
 int64_t phi(int64_t x, int64_t a)
 {
-  return phi(x, a, get_num_threads());
+  return cached_result(CACHE_PHI, x, a, [&] {
+    return phi(x, a, get_num_threads()); });
 }
 
 std::string primecount_version()
@@ -71,6 +71,60 @@ int primecount_pi_str(const char* x, char* res, size_t len)
   }
 }
 
+int64_t primecount_pi_interval(int64_t low, int64_t high)
+{
+  try
+  {
+    return primecount::pi(low, high);
+  }
+  catch(const std::exception& e)
+  {
+    std::cerr << "primecount_pi_interval: " << e.what() << std::endl;
+    return -1;
+  }
+}
+
+int primecount_pi_interval_str(const char* low, const char* high, char* res, size_t len)
+{
+  try
+  {
+    if (!low)
+      throw primecount::primecount_error("low must not be a NULL pointer");
+
+    if (!high)
+      throw primecount::primecount_error("high must not be a NULL pointer");
+
+    if (!res)
+      throw primecount::primecount_error("res must not be a NULL pointer");
+
+    std::string pix = primecount::pi(std::string(low), std::string(high));
+
+    // +1 required to add null at the end of the string
+    if (len < pix.length() + 1)
+    {
+      std::ostringstream oss;
+      oss << "res buffer too small, res.len = " << len << " < required = " << pix.length() + 1;
+      throw primecount::primecount_error(oss.str());
+    }
+
+    pix.copy(res, pix.length());
+    // std::string::copy does not append a null character
+    // at the end of the copied content.
+    res[pix.length()] = '\0';
+
+    return (int) pix.length();
+  }
+  catch(const std::exception& e)
+  {
+    std::cerr << "primecount_pi_interval_str: " << e.what() << std::endl;
+
+    if (res && len > 0)
+      res[0] = '\0';
+
+    return -1;
+  }
+}
+
 int64_t primecount_nth_prime(int64_t n)
 {
   try
@@ -84,6 +138,45 @@ int64_t primecount_nth_prime(int64_t n)
   }
 }
 
+int primecount_nth_prime_str(const char* n, char* res, size_t len)
+{
+  try
+  {
+    if (!n)
+      throw primecount::primecount_error("n must not be a NULL pointer");
+
+    if (!res)
+      throw primecount::primecount_error("res must not be a NULL pointer");
+
+    std::string str(n);
+    std::string prime = primecount::nth_prime(str);
+
+    // +1 required to add null at the end of the string
+    if (len < prime.length() + 1)
+    {
+      std::ostringstream oss;
+      oss << "res buffer too small, res.len = " << len << " < required = " << prime.length() + 1;
+      throw primecount::primecount_error(oss.str());
+    }
+
+    prime.copy(res, prime.length());
+    // std::string::copy does not append a null character
+    // at the end of the copied content.
+    res[prime.length()] = '\0';
+
+    return (int) prime.length();
+  }
+  catch(const std::exception& e)
+  {
+    std::cerr << "primecount_nth_prime_str: " << e.what() << std::endl;
+
+    if (res && len > 0)
+      res[0] = '\0';
+
+    return -1;
+  }
+}
+
 int64_t primecount_phi(int64_t x, int64_t a)
 {
   try
@@ -122,6 +215,35 @@ void primecount_set_num_threads(int threads)
   }
 }
 
+void primecount_set_result_cache_size(int64_t size)
+{
+  try
+  {
+    primecount::set_result_cache_size(size);
+  }
+  catch(const std::exception& e)
+  {
+    std::cerr << "primecount_set_result_cache_size: " << e.what() << std::endl;
+  }
+}
+
+int primecount_set_result_cache_file(const char* path)
+{
+  try
+  {
+    if (!path)
+      throw primecount::primecount_error("path must not be a NULL pointer");
+
+    primecount::set_result_cache_file(path);
+    return 0;
+  }
+  catch(const std::exception& e)
+  {
+    std::cerr << "primecount_set_result_cache_file: " << e.what() << std::endl;
+    return -1;
+  }
+}
+
 const char* primecount_get_max_x(void)
 {
 #ifdef HAVE_INT128_T
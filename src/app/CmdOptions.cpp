@@ -26,10 +26,12 @@
 #include <primecount-internal.hpp>
 #include <Vector.hpp>
 #include <print.hpp>
+#include <Numa.hpp>
 #include <int128_t.hpp>
 
 #include <stdint.h>
 #include <cstddef>
+#include <exception>
 #include <map>
 #include <string>
 #include <utility>
@@ -214,6 +216,58 @@ void CmdOptions::optionStatus(Option& opt)
     set_status_precision(opt.to<int>());
 }
 
+/// --serve[=PATH], if PATH is provided the requests
+/// are read from the Unix domain socket PATH,
+/// else the requests are read from stdin.
+///
+void CmdOptions::optionServe(Option& opt)
+{
+  serve = true;
+  socketPath = opt.val;
+}
+
+/// --max-memory=SIZE, SIZE is a number of bytes with
+/// an optional K, M, G or T (1024-based) suffix,
+/// e.g. --max-memory=16G.
+///
+void CmdOptions::optionMaxMemory(Option& opt)
+{
+  std::string val = opt.val;
+  double bytes = 1;
+
+  // Accept 16G, 16GB and 16GiB
+  if (!val.empty() && (val.back() == 'B' || val.back() == 'b'))
+    val.pop_back();
+  if (!val.empty() && (val.back() == 'i' || val.back() == 'I'))
+    val.pop_back();
+
+  if (!val.empty())
+  {
+    switch (val.back())
+    {
+      case 'K': case 'k': bytes = 1ll << 10; break;
+      case 'M': case 'm': bytes = 1ll << 20; break;
+      case 'G': case 'g': bytes = 1ll << 30; break;
+      case 'T': case 't': bytes = 1ll << 40; break;
+    }
+
+    if (bytes > 1)
+      val.pop_back();
+  }
+
+  try {
+    bytes *= std::stod(val);
+  }
+  catch (std::exception&) {
+    throw primecount_error("invalid option '" + opt.opt + "=" + opt.val + "'");
+  }
+
+  if (bytes <= 0)
+    throw primecount_error("invalid option '" + opt.opt + "=" + opt.val + "'");
+
+  set_max_memory(bytes);
+}
+
 CmdOptions parseOptions(int argc, char* argv[])
 {
   // No command-line options provided
@@ -227,6 +281,7 @@ CmdOptions parseOptions(int argc, char* argv[])
     { "--alpha", std::make_pair(OPTION_ALPHA, REQUIRED_PARAM) },
     { "--alpha-y", std::make_pair(OPTION_ALPHA_Y, REQUIRED_PARAM) },
     { "--alpha-z", std::make_pair(OPTION_ALPHA_Z, REQUIRED_PARAM) },
+    { "--batch", std::make_pair(OPTION_BATCH, REQUIRED_PARAM) },
     { "-d", std::make_pair(OPTION_DELEGLISE_RIVAT, NO_PARAM) },
     { "--deleglise-rivat", std::make_pair(OPTION_DELEGLISE_RIVAT, NO_PARAM) },
     { "--deleglise-rivat-64", std::make_pair(OPTION_DELEGLISE_RIVAT_64, NO_PARAM) },
@@ -246,11 +301,17 @@ CmdOptions parseOptions(int argc, char* argv[])
     { "--lmo3", std::make_pair(OPTION_LMO3, NO_PARAM) },
     { "--lmo4", std::make_pair(OPTION_LMO4, NO_PARAM) },
     { "--lmo5", std::make_pair(OPTION_LMO5, NO_PARAM) },
+    { "--lmo-128", std::make_pair(OPTION_LMO_128, NO_PARAM) },
     { "-m", std::make_pair(OPTION_MEISSEL, NO_PARAM) },
     { "--meissel", std::make_pair(OPTION_MEISSEL, NO_PARAM) },
+    { "--max-memory", std::make_pair(OPTION_MAX_MEMORY, REQUIRED_PARAM) },
+    { "--memory-estimate", std::make_pair(OPTION_MEMORY_ESTIMATE, NO_PARAM) },
+    { "--no-contiguous", std::make_pair(OPTION_NO_CONTIGUOUS, NO_PARAM) },
     { "-n", std::make_pair(OPTION_NTHPRIME, NO_PARAM) },
     { "--nth-prime", std::make_pair(OPTION_NTHPRIME, NO_PARAM) },
     { "--number", std::make_pair(OPTION_NUMBER, REQUIRED_PARAM) },
+    { "--numa", std::make_pair(OPTION_NUMA, REQUIRED_PARAM) },
+    { "--numa-pin", std::make_pair(OPTION_NUMA_PIN, NO_PARAM) },
     { "-p", std::make_pair(OPTION_PRIMESIEVE, NO_PARAM) },
     { "--primesieve", std::make_pair(OPTION_PRIMESIEVE, NO_PARAM) },
     { "--Li", std::make_pair(OPTION_LI, NO_PARAM) },
@@ -271,12 +332,14 @@ CmdOptions parseOptions(int argc, char* argv[])
     { "--D", std::make_pair(OPTION_D, NO_PARAM) },
     { "--Phi0", std::make_pair(OPTION_PHI0, NO_PARAM) },
     { "--Sigma", std::make_pair(OPTION_SIGMA, NO_PARAM) },
+    { "--serve", std::make_pair(OPTION_SERVE, OPTIONAL_PARAM) },
     { "-s", std::make_pair(OPTION_STATUS, OPTIONAL_PARAM) },
     { "--status", std::make_pair(OPTION_STATUS, OPTIONAL_PARAM) },
     { "--test", std::make_pair(OPTION_TEST, NO_PARAM) },
     { "--time", std::make_pair(OPTION_TIME, NO_PARAM) },
     { "-t", std::make_pair(OPTION_THREADS, REQUIRED_PARAM) },
     { "--threads", std::make_pair(OPTION_THREADS, REQUIRED_PARAM) },
+    { "--verify", std::make_pair(OPTION_VERIFY, NO_PARAM) },
     { "-v", std::make_pair(OPTION_VERSION, NO_PARAM) },
     { "--version", std::make_pair(OPTION_VERSION, NO_PARAM) }
   };
@@ -296,6 +359,13 @@ CmdOptions parseOptions(int argc, char* argv[])
       case OPTION_ALPHA_Z: set_alpha_z(opt.to<double>()); break;
       case OPTION_NUMBER:  numbers.push_back(opt.to<maxint_t>()); break;
       case OPTION_THREADS: set_num_threads(opt.to<int>()); break;
+      case OPTION_MAX_MEMORY: opts.optionMaxMemory(opt); break;
+      case OPTION_MEMORY_ESTIMATE: opts.memoryEstimate = true; break;
+      case OPTION_NO_CONTIGUOUS: set_contiguous_work(false); break;
+      case OPTION_NUMA:    set_numa_policy(opt.val); break;
+      case OPTION_NUMA_PIN: set_numa_pin(true); break;
+      case OPTION_SERVE:   opts.optionServe(opt); break;
+      case OPTION_BATCH:   opts.batchFile = opt.val; break;
       case OPTION_HELP:    help(/* exitCode */ 0); break;
       case OPTION_STATUS:  opts.optionStatus(opt); break;
       case OPTION_TIME:    opts.time = true; break;
@@ -305,6 +375,17 @@ CmdOptions parseOptions(int argc, char* argv[])
     }
   }
 
+  // In server and batch mode the numbers are read from
+  // stdin, from a Unix domain socket or from a file.
+  if (opts.serve || !opts.batchFile.empty())
+  {
+    if (!numbers.empty())
+      throw primecount_error("options --serve and --batch do not take numbers");
+    if (opts.serve && !opts.batchFile.empty())
+      throw primecount_error("incompatible options: --serve --batch");
+    return opts;
+  }
+
   if (opts.option == OPTION_PHI)
   {
     if (numbers.size() < 2)
@@ -317,6 +398,15 @@ CmdOptions parseOptions(int argc, char* argv[])
 
   opts.x = numbers[0];
 
+  // primecount low high: count the primes inside [low, high]
+  if (opts.option == OPTION_DEFAULT &&
+      numbers.size() >= 2)
+  {
+    opts.interval = true;
+    opts.low = numbers[0];
+    opts.x = numbers[1];
+  }
+
   return opts;
 }
 
@@ -24,6 +24,7 @@ enum OptionID
   OPTION_ALPHA,
   OPTION_ALPHA_Y,
   OPTION_ALPHA_Z,
+  OPTION_BATCH,
   OPTION_DEFAULT,
   OPTION_DELEGLISE_RIVAT,
   OPTION_DELEGLISE_RIVAT_64,
@@ -40,8 +41,14 @@ enum OptionID
   OPTION_LMO3,
   OPTION_LMO4,
   OPTION_LMO5,
+  OPTION_LMO_128,
+  OPTION_MAX_MEMORY,
   OPTION_MEISSEL,
+  OPTION_MEMORY_ESTIMATE,
+  OPTION_NO_CONTIGUOUS,
   OPTION_NTHPRIME,
+  OPTION_NUMA,
+  OPTION_NUMA_PIN,
   OPTION_NUMBER,
   OPTION_PRIMESIEVE,
   OPTION_LI,
@@ -54,6 +61,7 @@ enum OptionID
   OPTION_S2_EASY,
   OPTION_S2_HARD,
   OPTION_S2_TRIVIAL,
+  OPTION_SERVE,
   OPTION_AC,
   OPTION_B,
   OPTION_D,
@@ -62,6 +70,7 @@ enum OptionID
   OPTION_STATUS,
   OPTION_TEST,
   OPTION_TIME,
+  OPTION_VERIFY,
   OPTION_THREADS,
   OPTION_VERSION
 };
@@ -98,11 +107,19 @@ struct CmdOptions
   std::string optionStr;
   int option = OPTION_DEFAULT;
   maxint_t x = -1;
+  maxint_t low = -1;
   int64_t a = -1;
+  bool interval = false;
   bool time = false;
+  bool memoryEstimate = false;
+  bool serve = false;
+  std::string socketPath;
+  std::string batchFile;
 
   void setMainOption(OptionID optionID, const std::string& optStr);
   void optionStatus(Option& opt);
+  void optionMaxMemory(Option& opt);
+  void optionServe(Option& opt);
 };
 
 CmdOptions parseOptions(int, char**);
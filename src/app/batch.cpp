@@ -0,0 +1,244 @@
+///
+/// @file  batch.cpp
+/// @brief Batch mode (option: --batch FILE). Evaluates one
+///        request per line of FILE (or of stdin if FILE is "-")
+///        and prints one result per line. A line contains the
+///        numbers of a single primecount invocation, i.e. x,
+///        or "low high" (count the primes inside [low, high]),
+///        or "x a" together with --phi. The numbers are integer
+///        arithmetic expressions (see calculator.hpp). The
+///        function (--nth-prime, --Li, ...) is selected using
+///        the command-line options, e.g.:
+///
+///        primecount --batch values.txt --nth-prime --time
+///
+///        Spawning a new process per value is expensive for
+///        small values, hence consecutive small values are
+///        computed in parallel (using 1 thread per value), whereas
+///        large values are computed one at a time using all
+///        threads. The results are printed in input order.
+///        Empty lines and lines starting with '#' are ignored.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include "CmdOptions.hpp"
+
+#include <primecount.hpp>
+#include <primecount-internal.hpp>
+#include <primesieve.hpp>
+#include <int128_t.hpp>
+#include <print.hpp>
+#include <Vector.hpp>
+
+#include <stdint.h>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace primecount {
+
+maxint_t compute(const CmdOptions& opts, int threads);
+
+} // namespace
+
+namespace {
+
+using namespace primecount;
+
+/// Values <= 10^11 are computed in a few milliseconds
+/// using a single thread. For these values it is
+/// faster to compute multiple values in parallel.
+///
+const maxint_t max_small = (maxint_t) 1e11;
+
+struct Request
+{
+  CmdOptions opts;
+  std::string result;
+  double seconds = 0;
+  bool small = true;
+  bool error = false;
+};
+
+/// Parse the numbers of a single line and store them
+/// in a copy of the command-line options.
+///
+void parseLine(const std::string& line, Request& req)
+{
+  std::istringstream iss(line);
+  std::string token;
+  Vector<maxint_t> numbers;
+
+  while (iss >> token)
+    numbers.push_back(to_maxint(token));
+
+  if (numbers.empty() || numbers.size() > 2)
+    throw primecount_error("invalid line '" + line + "'");
+
+  CmdOptions& opts = req.opts;
+  opts.x = numbers[0];
+
+  if (numbers.size() == 2)
+  {
+    if (opts.option == OPTION_PHI)
+      opts.a = (int64_t) numbers[1];
+    else if (opts.option == OPTION_DEFAULT)
+    {
+      opts.interval = true;
+      opts.low = numbers[0];
+      opts.x = numbers[1];
+    }
+    else
+      throw primecount_error("invalid line '" + line + "'");
+  }
+  else if (opts.option == OPTION_PHI)
+    throw primecount_error("option --phi requires 2 numbers per line");
+
+  // The approximation functions are always fast
+  switch (opts.option)
+  {
+    case OPTION_LI:
+    case OPTION_LIINV:
+    case OPTION_R:
+    case OPTION_R_INVERSE:
+      req.small = true; break;
+    default:
+      req.small = opts.x <= max_small;
+  }
+}
+
+void compute(Request& req, int threads)
+{
+  if (req.error)
+    return;
+
+  double time = get_time();
+
+  try
+  {
+    req.result = to_string(compute(req.opts, threads));
+  }
+  catch (std::exception& e)
+  {
+    req.result = std::string("error: ") + e.what();
+  }
+
+  req.seconds = get_time() - time;
+}
+
+void printResult(const Request& req, bool time)
+{
+  std::cout << req.result;
+  if (time)
+    std::cout << '\t' << std::fixed << std::setprecision(3) << req.seconds;
+  std::cout << '\n';
+}
+
+/// Compute the small requests [start, stop[ in parallel
+/// using 1 thread per request and print the results.
+///
+void computeSmall(Vector<Request>& reqs,
+                  std::size_t start,
+                  std::size_t stop,
+                  int threads,
+                  bool time)
+{
+  int64_t size = (int64_t) (stop - start);
+  threads = ideal_num_threads(size, threads, 1);
+
+  // primesieve::count_primes() must
+  // not start additional threads.
+  int primesieve_threads = primesieve::get_num_threads();
+  if (threads > 1)
+    primesieve::set_num_threads(1);
+
+  #pragma omp parallel for schedule(dynamic, 1) num_threads(threads)
+  for (int64_t i = 0; i < size; i++)
+    compute(reqs[start + i], 1);
+
+  primesieve::set_num_threads(primesieve_threads);
+
+  for (std::size_t i = start; i < stop; i++)
+    printResult(reqs[i], time);
+
+  std::cout << std::flush;
+}
+
+} // namespace
+
+namespace primecount {
+
+void batch(const CmdOptions& opts)
+{
+  std::ifstream file;
+  std::istream* in = &std::cin;
+
+  if (opts.batchFile != "-")
+  {
+    file.open(opts.batchFile);
+    if (!file)
+      throw primecount_error("failed to open batch file: " + opts.batchFile);
+    in = &file;
+  }
+
+  // Status output would be mixed up with the results
+  set_print(false);
+
+  Vector<Request> reqs;
+  std::string line;
+
+  while (std::getline(*in, line))
+  {
+    std::size_t pos = line.find_first_not_of(" \t\r");
+    if (pos == std::string::npos || line[pos] == '#')
+      continue;
+
+    reqs.emplace_back();
+    Request& req = reqs.back();
+    req.opts = opts;
+
+    try
+    {
+      parseLine(line, req);
+    }
+    catch (std::exception& e)
+    {
+      // Printed in input order, not computed
+      req.result = std::string("error: ") + e.what();
+      req.small = true;
+      req.error = true;
+    }
+  }
+
+  int threads = get_num_threads();
+  std::size_t i = 0;
+
+  while (i < reqs.size())
+  {
+    if (reqs[i].small)
+    {
+      std::size_t j = i;
+      while (j < reqs.size() && reqs[j].small)
+        j++;
+
+      computeSmall(reqs, i, j, threads, opts.time);
+      i = j;
+    }
+    else
+    {
+      compute(reqs[i], threads);
+      printResult(reqs[i], opts.time);
+      std::cout << std::flush;
+      i++;
+    }
+  }
+}
+
+} // namespace
@@ -19,10 +19,14 @@ void help(int exitCode)
 {
   const std::string helpMenu =
     "Usage: primecount x [options]\n"
-    "Count the number of primes less than or equal to x (<= 10^31).\n"
+    "       primecount low high [options]\n"
+    "Count the number of primes less than or equal to x (<= 10^31)\n"
+    "or count the number of primes inside [low, high].\n"
     "\n"
     "Options:\n"
     "\n"
+    "      --batch=FILE         Compute one result per line of FILE (- for stdin),\n"
+    "                           small values are computed in parallel\n"
     "  -d, --deleglise-rivat    Count primes using the Deleglise-Rivat algorithm\n"
     "  -g, --gourdon            Count primes using Xavier Gourdon's algorithm.\n"
     "                           This is the default algorithm.\n"
@@ -30,20 +34,31 @@ void help(int exitCode)
     "      --lehmer             Count primes using Lehmer's formula\n"
     "      --lmo                Count primes using Lagarias-Miller-Odlyzko\n"
     "  -m, --meissel            Count primes using Meissel's formula\n"
+    "      --max-memory=SIZE    Limit memory usage e.g. 16G, automatically\n"
+    "                           decreases alpha_y, alpha_z and threads\n"
+    "      --memory-estimate    Print the predicted peak memory usage and exit\n"
+    "      --no-contiguous      Do not reuse a thread's sieve for contiguous work\n"
     "      --Li                 Eulerian logarithmic integral function\n"
     "      --Li-inverse         Approximate the nth prime using Li^-1(x)\n"
     "  -n, --nth-prime          Calculate the nth prime\n"
+    "      --numa=POLICY        NUMA placement of the lookup tables, POLICY is\n"
+    "                           default, interleave or replicate\n"
+    "      --numa-pin           Pin the threads to NUMA nodes\n"
     "  -p, --primesieve         Count primes using the sieve of Eratosthenes\n"
     "      --phi <X> <A>        phi(x, a) counts the numbers <= x that are not\n"
     "                           divisible by any of the first a primes\n"
     "  -R, --RiemannR           Approximate pi(x) using the Riemann R function\n"
     "      --RiemannR-inverse   Approximate the nth prime using R^-1(x)\n"
+    "      --serve[=PATH]       Read requests (e.g. '--nth-prime 1e9') line by line\n"
+    "                           from stdin or from the Unix domain socket PATH\n"
     "  -s, --status[=NUM]       Show computation progress 1%, 2%, 3%, ...\n"
     "                           Set digits after decimal point: -s1 prints 99.9%\n"
     "      --test               Run various correctness tests and exit\n"
     "      --time               Print the time elapsed in seconds\n"
     "  -t, --threads=NUM        Set the number of threads, 1 <= NUM <= CPU cores.\n"
     "                           By default primecount uses all available CPU cores.\n"
+    "      --verify             Verify pi(x) by computing it using both Gourdon's\n"
+    "                           and the Deleglise-Rivat algorithm\n"
     "  -v, --version            Print version and license information\n"
     "  -h, --help               Print this help menu\n"
     "\n"
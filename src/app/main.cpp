@@ -30,6 +30,7 @@
 #include <int128_t.hpp>
 #include <PhiTiny.hpp>
 #include <print.hpp>
+#include <result_cache.hpp>
 #include <S.hpp>
 
 #include <stdint.h>
@@ -343,6 +344,114 @@ maxint_t S2_hard(maxint_t x, int threads)
     return S2_hard(x, y, z, c, Li(x), threads);
 }
 
+void serve(const std::string& socketPath);
+void batch(const CmdOptions& opts);
+
+/// Compute the function selected by the user's
+/// command-line options (e.g. pi(x), nth_prime(n), ...).
+/// Also used by the --serve and --batch modes.
+///
+maxint_t compute(const CmdOptions& opts, int threads)
+{
+  auto x = opts.x;
+  auto a = opts.a;
+  maxint_t res = 0;
+
+  switch (opts.option)
+  {
+    case OPTION_DEFAULT:
+      if (opts.interval)
+        res = pi(opts.low, x, threads);
+      else
+        res = pi(x, threads);
+      break;
+    case OPTION_DELEGLISE_RIVAT:
+      res = pi_deleglise_rivat(x, threads); break;
+    case OPTION_DELEGLISE_RIVAT_64:
+      res = pi_deleglise_rivat_64(to_int64(x), threads); break;
+    case OPTION_GOURDON:
+      res = pi_gourdon(x, threads); break;
+    case OPTION_GOURDON_64:
+      res = pi_gourdon_64(to_int64(x), threads); break;
+    case OPTION_LEGENDRE:
+      res = pi_legendre(to_int64(x), threads); break;
+    case OPTION_LEHMER:
+      res = pi_lehmer(to_int64(x), threads); break;
+    case OPTION_LMO:
+#ifdef HAVE_INT128_T
+      if (x > pstd::numeric_limits<int64_t>::max())
+        res = pi_lmo_parallel_128(x, threads);
+      else
+#endif
+        res = pi_lmo_parallel(to_int64(x), threads);
+      break;
+    case OPTION_VERIFY:
+#ifdef HAVE_INT128_T
+      if (x > pstd::numeric_limits<int64_t>::max())
+        res = pi_verify_128(x, threads);
+      else
+#endif
+        res = pi_verify_64(to_int64(x), threads);
+      break;
+    case OPTION_LMO1:
+      res = pi_lmo1(to_int64(x)); break;
+    case OPTION_LMO2:
+      res = pi_lmo2(to_int64(x)); break;
+    case OPTION_LMO3:
+      res = pi_lmo3(to_int64(x)); break;
+    case OPTION_LMO4:
+      res = pi_lmo4(to_int64(x)); break;
+    case OPTION_LMO5:
+      res = pi_lmo5(to_int64(x)); break;
+    case OPTION_MEISSEL:
+      res = pi_meissel(to_int64(x), threads); break;
+    case OPTION_PRIMESIEVE:
+      res = pi_primesieve(to_int64(x)); break;
+    case OPTION_LI:
+      res = Li(x); break;
+    case OPTION_LIINV:
+      res = Li_inverse(x); break;
+    case OPTION_R:
+      res = RiemannR(x); break;
+    case OPTION_R_INVERSE:
+      res = RiemannR_inverse(x); break;
+    case OPTION_NTHPRIME:
+      res = cached_result(CACHE_NTH_PRIME, x, 0, [&] { return nth_prime(x, threads); }); break;
+    case OPTION_PHI:
+      res = cached_result(CACHE_PHI, to_int64(x), a, [&] { return phi(to_int64(x), a, threads); }); break;
+    case OPTION_P2:
+      res = P2(x, threads); break;
+    case OPTION_S1:
+      res = S1(x, threads); break;
+    case OPTION_S2_EASY:
+      res = S2_easy(x, threads); break;
+    case OPTION_S2_HARD:
+      res = S2_hard(x, threads); break;
+    case OPTION_S2_TRIVIAL:
+      res = S2_trivial(x, threads); break;
+    case OPTION_AC:
+      res = AC(x, threads); break;
+    case OPTION_B:
+      res = B(x, threads); break;
+    case OPTION_D:
+      res = D(x, threads); break;
+    case OPTION_PHI0:
+      res = Phi0(x, threads); break;
+    case OPTION_SIGMA:
+      res = Sigma(x, threads); break;
+#ifdef HAVE_INT128_T
+    case OPTION_DELEGLISE_RIVAT_128:
+      res = pi_deleglise_rivat_128(x, threads); break;
+    case OPTION_LMO_128:
+      res = pi_lmo_parallel_128(x, threads); break;
+    case OPTION_GOURDON_128:
+      res = pi_gourdon_128(x, threads); break;
+#endif
+  }
+
+  return res;
+}
+
 } // namespace
 
 int main (int argc, char* argv[])
@@ -353,82 +462,43 @@ int main (int argc, char* argv[])
     double time = get_time();
 
     auto x = opts.x;
-    auto a = opts.a;
     auto threads = get_num_threads();
     maxint_t res = 0;
 
-    switch (opts.option)
+    if (opts.serve)
     {
-      case OPTION_DEFAULT:
-        res = pi(x, threads); break;
-      case OPTION_DELEGLISE_RIVAT:
-        res = pi_deleglise_rivat(x, threads); break;
-      case OPTION_DELEGLISE_RIVAT_64:
-        res = pi_deleglise_rivat_64(to_int64(x), threads); break;
-      case OPTION_GOURDON:
-        res = pi_gourdon(x, threads); break;
-      case OPTION_GOURDON_64:
-        res = pi_gourdon_64(to_int64(x), threads); break;
-      case OPTION_LEGENDRE:
-        res = pi_legendre(to_int64(x), threads); break;
-      case OPTION_LEHMER:
-        res = pi_lehmer(to_int64(x), threads); break;
-      case OPTION_LMO:
-        res = pi_lmo_parallel(to_int64(x), threads); break;
-      case OPTION_LMO1:
-        res = pi_lmo1(to_int64(x)); break;
-      case OPTION_LMO2:
-        res = pi_lmo2(to_int64(x)); break;
-      case OPTION_LMO3:
-        res = pi_lmo3(to_int64(x)); break;
-      case OPTION_LMO4:
-        res = pi_lmo4(to_int64(x)); break;
-      case OPTION_LMO5:
-        res = pi_lmo5(to_int64(x)); break;
-      case OPTION_MEISSEL:
-        res = pi_meissel(to_int64(x), threads); break;
-      case OPTION_PRIMESIEVE:
-        res = pi_primesieve(to_int64(x)); break;
-      case OPTION_LI:
-        res = Li(x); break;
-      case OPTION_LIINV:
-        res = Li_inverse(x); break;
-      case OPTION_R:
-        res = RiemannR(x); break;
-      case OPTION_R_INVERSE:
-        res = RiemannR_inverse(x); break;
-      case OPTION_NTHPRIME:
-        res = nth_prime(to_int64(x), threads); break;
-      case OPTION_PHI:
-        res = phi(to_int64(x), a, threads); break;
-      case OPTION_P2:
-        res = P2(x, threads); break;
-      case OPTION_S1:
-        res = S1(x, threads); break;
-      case OPTION_S2_EASY:
-        res = S2_easy(x, threads); break;
-      case OPTION_S2_HARD:
-        res = S2_hard(x, threads); break;
-      case OPTION_S2_TRIVIAL:
-        res = S2_trivial(x, threads); break;
-      case OPTION_AC:
-        res = AC(x, threads); break;
-      case OPTION_B:
-        res = B(x, threads); break;
-      case OPTION_D:
-        res = D(x, threads); break;
-      case OPTION_PHI0:
-        res = Phi0(x, threads); break;
-      case OPTION_SIGMA:
-        res = Sigma(x, threads); break;
-#ifdef HAVE_INT128_T
-      case OPTION_DELEGLISE_RIVAT_128:
-        res = pi_deleglise_rivat_128(x, threads); break;
-      case OPTION_GOURDON_128:
-        res = pi_gourdon_128(x, threads); break;
-#endif
+      serve(opts.socketPath);
+      return 0;
+    }
+
+    if (!opts.batchFile.empty())
+    {
+      batch(opts);
+      return 0;
+    }
+
+    if (opts.memoryEstimate)
+    {
+      switch (opts.option)
+      {
+        case OPTION_DEFAULT:
+        case OPTION_GOURDON:
+        case OPTION_GOURDON_64:
+        case OPTION_GOURDON_128:
+          print_memory_usage_gourdon(x, threads); break;
+        case OPTION_DELEGLISE_RIVAT:
+        case OPTION_DELEGLISE_RIVAT_64:
+        case OPTION_DELEGLISE_RIVAT_128:
+          print_memory_usage_deleglise_rivat(x, threads); break;
+        default:
+          throw primecount_error("option --memory-estimate requires --gourdon or --deleglise-rivat");
+      }
+
+      return 0;
     }
 
+    res = compute(opts, threads);
+
     if (is_print_combined_result())
     {
       // Add empty line after last partial formula
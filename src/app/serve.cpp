@@ -0,0 +1,314 @@
+///
+/// @file  serve.cpp
+/// @brief Server mode (option: --serve[=PATH]). Reads newline
+///        delimited requests from stdin (or from the Unix domain
+///        socket PATH) and writes one result line per request.
+///        Each request uses the same syntax as the primecount
+///        command-line application, e.g.:
+///
+///        1e15
+///        1e15 1e15+1e9
+///        --nth-prime 1e12 --threads=4
+///        --phi 1e12 10
+///        --Li 1e20
+///
+///        The result line contains either the result or
+///        "error: <message>". Since the primecount process keeps
+///        running between requests, the OpenMP thread pool,
+///        primesieve's and primecount's internal caches (e.g.
+///        PiTable::pi_cache) are reused by the next requests.
+///        The PiTable and FactorTable lookup tables are not kept
+///        between requests, their size depends on x and building
+///        them takes less than 0.1% of the run time of pi(x).
+///        "quit" closes the connection, "shutdown" stops the
+///        Unix domain socket server.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include "CmdOptions.hpp"
+
+#include <primecount.hpp>
+#include <primecount-internal.hpp>
+#include <int128_t.hpp>
+#include <print.hpp>
+#include <Vector.hpp>
+
+#include <exception>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <csignal>
+  #include <sys/socket.h>
+  #include <sys/stat.h>
+  #include <sys/un.h>
+  #include <unistd.h>
+  #define HAVE_UNIX_SOCKET
+#endif
+
+namespace primecount {
+
+maxint_t compute(const CmdOptions& opts, int threads);
+
+} // namespace
+
+namespace {
+
+using namespace primecount;
+
+/// Options that are allowed inside of a request. Options
+/// that change global settings (other than the number of
+/// threads which is restored after each request) or
+/// options that exit the process are not allowed.
+///
+const std::set<std::string> requestOptions =
+{
+  "-d", "--deleglise-rivat", "--deleglise-rivat-64", "--deleglise-rivat-128",
+  "-g", "--gourdon", "--gourdon-64", "--gourdon-128",
+  "-l", "--legendre", "--lehmer", "-m", "--meissel",
+  "--lmo", "--lmo1", "--lmo2", "--lmo3", "--lmo4", "--lmo5",
+  "-n", "--nth-prime", "-p", "--primesieve", "--phi",
+  "--Li", "--Li-inverse", "-R", "--RiemannR", "--RiemannR-inverse",
+  "--P2", "--S1", "--S2-trivial", "--S2-easy", "--S2-hard",
+  "--AC", "-B", "--B", "-D", "--D", "--Phi0", "--Sigma",
+  "-t", "--threads"
+};
+
+/// Returns the option name without its value,
+/// e.g. "--threads=4" -> "--threads", "-t4" -> "-t".
+/// Note that option names may contain digits,
+/// e.g. "--P2" or "--gourdon-64".
+///
+std::string optionName(const std::string& str)
+{
+  std::string name = str.substr(0, str.find('='));
+
+  // Short options may be directly
+  // followed by their value.
+  if (!requestOptions.count(name) &&
+      name.size() > 2 &&
+      name[1] != '-')
+    name = name.substr(0, 2);
+
+  return name;
+}
+
+/// Process a single request and return the result line
+/// (without trailing newline).
+///
+std::string handleRequest(const std::string& line)
+{
+  std::istringstream iss(line);
+  std::string token;
+  Vector<std::string> args;
+  args.push_back("primecount");
+
+  while (iss >> token)
+  {
+    if (token.size() >= 2 &&
+        token[0] == '-' &&
+        !(token[1] >= '0' && token[1] <= '9'))
+    {
+      std::string name = optionName(token);
+      if (!requestOptions.count(name))
+        return "error: option '" + name + "' not allowed in --serve mode";
+    }
+
+    args.push_back(token);
+  }
+
+  Vector<char*> argv;
+  for (std::string& arg : args)
+    argv.push_back(&arg[0]);
+
+  int threads = get_num_threads();
+
+  try
+  {
+    CmdOptions opts = parseOptions((int) argv.size(), argv.data());
+    maxint_t res = compute(opts, get_num_threads());
+    set_num_threads(threads);
+    return to_string(res);
+  }
+  catch (std::exception& e)
+  {
+    set_num_threads(threads);
+    return std::string("error: ") + e.what();
+  }
+}
+
+/// Returns true if the line contains no request
+bool isBlank(const std::string& line)
+{
+  return line.find_first_not_of(" \t\r") == std::string::npos;
+}
+
+/// Remove leading and trailing whitespace
+std::string trim(const std::string& line)
+{
+  std::size_t first = line.find_first_not_of(" \t\r");
+  std::size_t last = line.find_last_not_of(" \t\r");
+  return line.substr(first, last - first + 1);
+}
+
+void serveStdin()
+{
+  std::string line;
+
+  while (std::getline(std::cin, line))
+  {
+    if (isBlank(line))
+      continue;
+    if (trim(line) == "quit" ||
+        trim(line) == "shutdown")
+      break;
+
+    std::cout << handleRequest(line) << std::endl;
+  }
+}
+
+#if defined(HAVE_UNIX_SOCKET)
+
+/// Returns true if path is a Unix domain socket
+bool isSocket(const std::string& path)
+{
+  struct stat st;
+  return lstat(path.c_str(), &st) == 0 &&
+         S_ISSOCK(st.st_mode);
+}
+
+bool writeAll(int fd, const std::string& str)
+{
+  std::size_t pos = 0;
+
+  while (pos < str.size())
+  {
+    ssize_t bytes = write(fd, str.data() + pos, str.size() - pos);
+    if (bytes <= 0)
+      return false;
+    pos += (std::size_t) bytes;
+  }
+
+  return true;
+}
+
+/// Serve the requests of a single client connection.
+/// Returns true if the client sent "shutdown".
+///
+bool serveClient(int fd)
+{
+  std::string buffer;
+  char chunk[4096];
+
+  while (true)
+  {
+    ssize_t bytes = read(fd, chunk, sizeof(chunk));
+    if (bytes <= 0)
+      return false;
+
+    buffer.append(chunk, (std::size_t) bytes);
+    std::size_t pos;
+
+    while ((pos = buffer.find('\n')) != std::string::npos)
+    {
+      std::string line = buffer.substr(0, pos);
+      buffer.erase(0, pos + 1);
+
+      if (isBlank(line))
+        continue;
+      if (trim(line) == "quit")
+        return false;
+      if (trim(line) == "shutdown")
+        return true;
+      if (!writeAll(fd, handleRequest(line) + "\n"))
+        return false;
+    }
+  }
+}
+
+void serveSocket(const std::string& path)
+{
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+
+  if (path.size() >= sizeof(addr.sun_path))
+    throw primecount_error("--serve: socket path too long: " + path);
+
+  path.copy(addr.sun_path, path.size());
+
+  // Remove the socket of a previous server,
+  // other files are never deleted.
+  struct stat st;
+  if (lstat(path.c_str(), &st) == 0)
+  {
+    if (!S_ISSOCK(st.st_mode))
+      throw primecount_error("--serve: " + path + " exists and is not a socket");
+    unlink(path.c_str());
+  }
+
+  int server = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (server < 0)
+    throw primecount_error("--serve: failed to create socket");
+
+  // A client closing its connection early
+  // must not terminate the server.
+  std::signal(SIGPIPE, SIG_IGN);
+
+  if (bind(server, (sockaddr*) &addr, sizeof(addr)) != 0 ||
+      listen(server, 16) != 0)
+  {
+    close(server);
+    throw primecount_error("--serve: failed to bind socket " + path);
+  }
+
+  bool shutdown = false;
+
+  // Requests are processed sequentially, each
+  // request uses all threads of the thread pool.
+  while (!shutdown)
+  {
+    int client = accept(server, nullptr, nullptr);
+    if (client < 0)
+      continue;
+
+    shutdown = serveClient(client);
+    close(client);
+  }
+
+  close(server);
+
+  if (isSocket(path))
+    unlink(path.c_str());
+}
+
+#endif
+
+} // namespace
+
+namespace primecount {
+
+void serve(const std::string& socketPath)
+{
+  // Status output would be mixed up with the results
+  set_print(false);
+
+  if (socketPath.empty())
+  {
+    serveStdin();
+    return;
+  }
+
+#if defined(HAVE_UNIX_SOCKET)
+  serveSocket(socketPath);
+#else
+  throw primecount_error("--serve: Unix domain sockets are not supported on this OS");
+#endif
+}
+
+} // namespace
@@ -44,7 +44,8 @@ T S2_easy_OpenMP(T x,
                  int64_t c,
                  const Primes& primes,
                  int threads,
-                 bool is_print)
+                 bool is_print,
+                 bool is_compact)
 {
   T sum = 0;
   int64_t x13 = iroot<3>(x);
@@ -57,7 +58,7 @@ T S2_easy_OpenMP(T x,
   threads = ideal_num_threads(x13, threads, thread_threshold);
 
   StatusS2 status(x);
-  PiTable pi(y, threads);
+  PiTable pi(y, threads, is_compact);
   int64_t pi_sqrty = pi[isqrt(y)];
   int64_t pi_x13 = pi[x13];
   RelaxedAtomic<int64_t> min_b(max(c, pi_sqrty) + 1);
@@ -123,7 +124,8 @@ int64_t S2_easy(int64_t x,
                 int64_t z,
                 int64_t c,
                 int threads,
-                bool is_print)
+                bool is_print,
+                bool is_compact)
 {
   double time;
 
@@ -136,7 +138,7 @@ int64_t S2_easy(int64_t x,
   }
 
   auto primes = generate_primes<uint32_t>(y);
-  int64_t sum = S2_easy_OpenMP((uint64_t) x, y, z, c, primes, threads, is_print);
+  int64_t sum = S2_easy_OpenMP((uint64_t) x, y, z, c, primes, threads, is_print, is_compact);
 
   if (is_print)
     print("S2_easy", sum, time);
@@ -151,7 +153,8 @@ int128_t S2_easy(int128_t x,
                  int64_t z,
                  int64_t c,
                  int threads,
-                 bool is_print)
+                 bool is_print,
+                 bool is_compact)
 {
   double time;
 
@@ -169,12 +172,12 @@ int128_t S2_easy(int128_t x,
   if (y <= pstd::numeric_limits<uint32_t>::max())
   {
     auto primes = generate_primes<uint32_t>(y);
-    sum = S2_easy_OpenMP((uint128_t) x, y, z, c, primes, threads, is_print);
+    sum = S2_easy_OpenMP((uint128_t) x, y, z, c, primes, threads, is_print, is_compact);
   }
   else
   {
     auto primes = generate_primes<int64_t>(y);
-    sum = S2_easy_OpenMP((uint128_t) x, y, z, c, primes, threads, is_print);
+    sum = S2_easy_OpenMP((uint128_t) x, y, z, c, primes, threads, is_print, is_compact);
   }
 
   if (is_print)
@@ -28,6 +28,7 @@
 #include <PiTable.hpp>
 #include <FactorTable.hpp>
 #include <Sieve.hpp>
+#include <ThreadSieve.hpp>
 #include <fast_div.hpp>
 #include <generate_primes.hpp>
 #include <phi_vector.hpp>
@@ -65,7 +66,8 @@ T S2_hard_thread(T x,
                  const Primes& primes,
                  const PiTable& pi,
                  const FactorTable& factor,
-                 ThreadData& thread)
+                 ThreadData& thread,
+                 ThreadSieve& threadSieve)
 {
   T sum = 0;
 
@@ -83,8 +85,12 @@ T S2_hard_thread(T x,
   if (min_b > max_b)
     return 0;
 
-  Vector<int64_t> phi = phi_vector(low, max_b, primes, pi);
-  Sieve sieve(low, segment_size, max_b);
+  // Carry forward phi[] and the sieve if the thread's
+  // previous work interval ended at low.
+  bool is_contiguous = thread.is_contiguous;
+  thread.is_carried = threadSieve.init(is_contiguous, low, limit, segment_size, min_b, max_b, primes, pi);
+  Vector<int64_t>& phi = threadSieve.phi();
+  Sieve& sieve = threadSieve.sieve();
   thread.init_finished();
 
   // Segmented sieve of Eratosthenes
@@ -195,7 +201,8 @@ T S2_hard_OpenMP(T x,
                  const Primes& primes,
                  const FactorTable& factor,
                  int threads,
-                 bool is_print)
+                 bool is_print,
+                 bool is_compact)
 {
   // These load balancing settings work well on my
   // dual-socket AMD EPYC 7642 server with 192 CPU cores.
@@ -206,11 +213,12 @@ T S2_hard_OpenMP(T x,
 
   LoadBalancerS2 loadBalancer(x, z, s2_hard_approx, threads, is_print);
   int64_t max_prime = min(y, z / isqrt(y));
-  PiTable pi(max_prime, threads);
+  PiTable pi(max_prime, threads, is_compact);
 
   #pragma omp parallel num_threads(threads)
   {
     ThreadData thread;
+    ThreadSieve threadSieve;
 
     while (loadBalancer.get_work(thread))
     {
@@ -219,12 +227,15 @@ T S2_hard_OpenMP(T x,
       using UT = typename pstd::make_unsigned<T>::type;
 
       thread.start_time();
-      UT sum = S2_hard_thread((UT) x, y, z, c, primes, pi, factor, thread);
+      UT sum = S2_hard_thread((UT) x, y, z, c, primes, pi, factor, thread, threadSieve);
       thread.sum = (T) sum;
       thread.stop_time();
     }
   }
 
+  if (is_print)
+    loadBalancer.print_init_time();
+
   T sum = (T) loadBalancer.get_sum();
 
   return sum;
@@ -240,7 +251,8 @@ int64_t S2_hard(int64_t x,
                 int64_t c,
                 int64_t s2_hard_approx,
                 int threads,
-                bool is_print)
+                bool is_print,
+                bool is_compact)
 {
   double time;
 
@@ -255,7 +267,7 @@ int64_t S2_hard(int64_t x,
   FactorTable<uint16_t> factor(y, threads);
   int64_t max_prime = min(y, z / isqrt(y));
   auto primes = generate_primes<uint32_t>(max_prime);
-  int64_t sum = S2_hard_OpenMP(x, y, z, c, s2_hard_approx, primes, factor, threads, is_print);
+  int64_t sum = S2_hard_OpenMP(x, y, z, c, s2_hard_approx, primes, factor, threads, is_print, is_compact);
 
   if (is_print)
     print("S2_hard", sum, time);
@@ -271,7 +283,8 @@ int128_t S2_hard(int128_t x,
                  int64_t c,
                  int128_t s2_hard_approx,
                  int threads,
-                 bool is_print)
+                 bool is_print,
+                 bool is_compact)
 {
   double time;
 
@@ -291,14 +304,14 @@ int128_t S2_hard(int128_t x,
     FactorTable<uint16_t> factor(y, threads);
     int64_t max_prime = min(y, z / isqrt(y));
     auto primes = generate_primes<uint32_t>(max_prime);
-    sum = S2_hard_OpenMP(x, y, z, c, s2_hard_approx, primes, factor, threads, is_print);
+    sum = S2_hard_OpenMP(x, y, z, c, s2_hard_approx, primes, factor, threads, is_print, is_compact);
   }
   else
   {
     FactorTable<uint32_t> factor(y, threads);
     int64_t max_prime = min(y, z / isqrt(y));
     auto primes = generate_primes<int64_t>(max_prime);
-    sum = S2_hard_OpenMP(x, y, z, c, s2_hard_approx, primes, factor, threads, is_print);
+    sum = S2_hard_OpenMP(x, y, z, c, s2_hard_approx, primes, factor, threads, is_print, is_compact);
   }
 
   if (is_print)
@@ -40,12 +40,13 @@ T S2_trivial(T x,
              int64_t y,
              int64_t z,
              int64_t c,
-             int threads)
+             int threads,
+             bool is_compact)
 {
   if (y < 2)
     return 0;
 
-  PiTable pi(y, threads);
+  PiTable pi(y, threads, is_compact);
   int64_t pi_y = pi[y];
   int64_t sqrtz = isqrt(z);
   int64_t prime_c = nth_prime(c);
@@ -97,7 +98,8 @@ int64_t S2_trivial(int64_t x,
                    int64_t z,
                    int64_t c,
                    int threads,
-                   bool is_print)
+                   bool is_print,
+                   bool is_compact)
 {
   double time;
 
@@ -109,7 +111,7 @@ int64_t S2_trivial(int64_t x,
     time = get_time();
   }
 
-  int64_t sum = ::S2_trivial(x, y, z, c, threads);
+  int64_t sum = ::S2_trivial(x, y, z, c, threads, is_compact);
 
   if (is_print)
     print("S2_trivial", sum, time);
@@ -124,7 +126,8 @@ int128_t S2_trivial(int128_t x,
                     int64_t z,
                     int64_t c,
                     int threads,
-                    bool is_print)
+                    bool is_print,
+                    bool is_compact)
 {
   double time;
 
@@ -136,7 +139,7 @@ int128_t S2_trivial(int128_t x,
     time = get_time();
   }
 
-  int128_t sum = ::S2_trivial(x, y, z, c, threads);
+  int128_t sum = ::S2_trivial(x, y, z, c, threads, is_compact);
 
   if (is_print)
     print("S2_trivial", sum, time);
@@ -21,6 +21,7 @@
 
 #include <primecount.hpp>
 #include <primecount-internal.hpp>
+#include <AsyncContext.hpp>
 #include <imath.hpp>
 #include <PhiTiny.hpp>
 #include <int128_t.hpp>
@@ -43,12 +44,16 @@ T S2(T x,
      int64_t c,
      T s2_approx,
      int threads,
-     bool is_print)
+     bool is_print,
+     bool is_compact)
 {
-  T s2_trivial = S2_trivial(x, y, z, c, threads, is_print);
-  T s2_easy = S2_easy(x, y, z, c, threads, is_print);
+  T s2_trivial = S2_trivial(x, y, z, c, threads, is_print, is_compact);
+  check_cancelled();
+  T s2_easy = S2_easy(x, y, z, c, threads, is_print, is_compact);
+  check_cancelled();
   T s2_hard_approx = s2_approx - (s2_trivial + s2_easy);
-  T s2_hard = S2_hard(x, y, z, c, s2_hard_approx, threads, is_print);
+  T s2_hard = S2_hard(x, y, z, c, s2_hard_approx, threads, is_print, is_compact);
+  check_cancelled();
   T s2 = s2_trivial + s2_easy + s2_hard;
 
   return s2;
@@ -74,6 +79,13 @@ int64_t pi_deleglise_rivat_64(int64_t x,
   int64_t x13 = iroot<3>(x);
   int64_t y = (int64_t) (x13 * alpha);
   int64_t z = x / y;
+
+  // Use the compact PiTable layout and reduce the
+  // number of threads if the predicted memory
+  // usage exceeds the user's --max-memory.
+  bool is_compact = is_compact_pi_table_deleglise_rivat(x, y, threads);
+  threads = max_memory_threads_deleglise_rivat(x, y, threads, is_compact);
+
   int64_t pi_y = pi_noprint(y, threads);
   int64_t c = PhiTiny::get_c(y);
 
@@ -85,10 +97,14 @@ int64_t pi_deleglise_rivat_64(int64_t x,
     print(x, y, z, c, threads);
   }
 
+  // A cancelled pi_async() computation
+  // stops before the next formula.
   int64_t p2 = P2(x, y, pi_y, threads, is_print);
+  check_cancelled();
   int64_t s1 = S1(x, y, c, threads, is_print);
+  check_cancelled();
   int64_t s2_approx = S2_approx(x, pi_y, p2, s1);
-  int64_t s2 = S2(x, y, z, c, s2_approx, threads, is_print);
+  int64_t s2 = S2(x, y, z, c, s2_approx, threads, is_print, is_compact);
   int64_t phi = s1 + s2;
   int64_t sum = phi + pi_y - 1 - p2;
 
@@ -117,6 +133,13 @@ int128_t pi_deleglise_rivat_128(int128_t x,
 
   int64_t y = (int64_t) (iroot<3>(x) * alpha);
   int64_t z = (int64_t) (x / y);
+
+  // Use the compact PiTable layout and reduce the
+  // number of threads if the predicted memory
+  // usage exceeds the user's --max-memory.
+  bool is_compact = is_compact_pi_table_deleglise_rivat(x, y, threads);
+  threads = max_memory_threads_deleglise_rivat(x, y, threads, is_compact);
+
   int64_t pi_y = pi_noprint(y, threads);
   int64_t c = PhiTiny::get_c(y);
 
@@ -128,10 +151,14 @@ int128_t pi_deleglise_rivat_128(int128_t x,
     print(x, y, z, c, threads);
   }
 
+  // A cancelled pi_async() computation
+  // stops before the next formula.
   int128_t p2 = P2(x, y, pi_y, threads, is_print);
+  check_cancelled();
   int128_t s1 = S1(x, y, c, threads, is_print);
+  check_cancelled();
   int128_t s2_approx = S2_approx(x, pi_y, p2, s1);
-  int128_t s2 = S2(x, y, z, c, s2_approx, threads, is_print);
+  int128_t s2 = S2(x, y, z, c, s2_approx, threads, is_print, is_compact);
   int128_t phi = s1 + s2;
   int128_t sum = phi + pi_y - 1 - p2;
 
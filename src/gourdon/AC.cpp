@@ -29,6 +29,7 @@
 #include <SegmentedPiTable.hpp>
 #include <primecount-internal.hpp>
 #include <LoadBalancerAC.hpp>
+#include <Numa.hpp>
 #include <fast_div.hpp>
 #include <generate_primes.hpp>
 #include <gourdon.hpp>
@@ -205,7 +206,8 @@ T AC_OpenMP(T x,
             int64_t max_a_prime,
             const Primes& primes,
             int threads,
-            bool is_print)
+            bool is_print,
+            bool is_compact)
 {
   T sum = 0;
   int64_t x13 = iroot<3>(x);
@@ -225,12 +227,13 @@ T AC_OpenMP(T x,
   // PiTable is accessed much less frequently than
   // SegmentedPiTable, hence it is OK that PiTable's size
   // is fairly large and does not fit into the CPU's cache.
-  PiTable pi(max(z, max_a_prime), threads);
+  NumaReplicas<PiTable> piTables(max(z, max_a_prime), threads, is_compact);
+  const PiTable& pi0 = piTables.local();
 
-  int64_t pi_y = pi[y];
-  int64_t pi_sqrtz = pi[isqrt(z)];
-  int64_t pi_root3_xy = pi[iroot<3>(xy)];
-  int64_t pi_root3_xz = pi[iroot<3>(xz)];
+  int64_t pi_y = pi0[y];
+  int64_t pi_sqrtz = pi0[isqrt(z)];
+  int64_t pi_root3_xy = pi0[iroot<3>(xy)];
+  int64_t pi_root3_xz = pi0[iroot<3>(xz)];
   RelaxedAtomic<int64_t> min_c1(max(k, pi_root3_xz) + 1);
 
   // In order to reduce the thread creation & destruction
@@ -243,12 +246,19 @@ T AC_OpenMP(T x,
   //
   #pragma omp parallel num_threads(threads) reduction(+: sum)
   {
+    // Use the PiTable of the thread's NUMA node
+    NumaPinThread numaPin(threads);
+    const PiTable& pi = piTables.local();
+
     // C1 formula: pi[(x/z)^(1/3)] < b <= pi[pi_sqrtz]
     // There are very few iterations in this loop,
     // hence the use of an atomic loop counter (min_c1)
     // won't cause any scaling issues.
     for (int64_t b = min_c1++; b <= pi_sqrtz; b = min_c1++)
     {
+      if (loadBalancer.is_cancelled())
+        break;
+
       int64_t prime = primes[b];
       T xp = x / prime;
       int64_t max_m = min(xp / prime, z);
@@ -272,6 +282,8 @@ T AC_OpenMP(T x,
       int64_t segment_size = thread.segment_size;
       int64_t limit = low + thread.segments * segment_size;
       limit = min(limit, sqrtx);
+      double init_time = get_time();
+      T thread_sum = 0;
 
       for (; low < limit; low += segment_size)
       {
@@ -286,7 +298,10 @@ T AC_OpenMP(T x,
         // to 0 then we increase the number of segments in the
         // loadBalancer which should improve performance.
         if (low == thread.low)
+        {
           thread.secs = get_time();
+          thread.init_secs = thread.secs - init_time;
+        }
 
         T xlow = x / max(low, 1);
         T xhigh = x / high;
@@ -309,12 +324,18 @@ T AC_OpenMP(T x,
 
         // C2 formula: pi[sqrt(z)] < b <= pi[x_star]
         for (int64_t b = min_c2; b <= max_c2; b++)
-          sum += C2(x, xlow, xhigh, y, b, primes, pi, segmentedPi);
+          thread_sum += C2(x, xlow, xhigh, y, b, primes, pi, segmentedPi);
 
         // A formula: pi[x_star] < b <= pi[x13]
         for (int64_t b = min_a; b <= max_a; b++)
-          sum += A(x, xlow, xhigh, y, b, primes, pi, segmentedPi);
+          thread_sum += A(x, xlow, xhigh, y, b, primes, pi, segmentedPi);
       }
+
+      // The partial sum of the current work
+      // interval is traced by get_work().
+      using ST = typename pstd::make_signed<T>::type;
+      thread.sum = (ST) thread_sum;
+      sum += thread_sum;
     }
   }
 
@@ -330,7 +351,8 @@ int64_t AC(int64_t x,
            int64_t z,
            int64_t k,
            int threads,
-           bool is_print)
+           bool is_print,
+           bool is_compact)
 {
   double time;
 
@@ -348,7 +370,7 @@ int64_t AC(int64_t x,
   int64_t max_prime = max(max_a_prime, max_c_prime);
   auto primes = generate_primes<uint32_t>(max_prime);
 
-  int64_t sum = AC_OpenMP((uint64_t) x, y, z, k, x_star, max_a_prime, primes, threads, is_print);
+  int64_t sum = AC_OpenMP((uint64_t) x, y, z, k, x_star, max_a_prime, primes, threads, is_print, is_compact);
 
   if (is_print)
     print("A + C", sum, time);
@@ -363,7 +385,8 @@ int128_t AC(int128_t x,
             int64_t z,
             int64_t k,
             int threads,
-            bool is_print)
+            bool is_print,
+            bool is_compact)
 {
   double time;
 
@@ -385,12 +408,12 @@ int128_t AC(int128_t x,
   if (max_prime <= pstd::numeric_limits<uint32_t>::max())
   {
     auto primes = generate_primes<uint32_t>(max_prime);
-    sum = AC_OpenMP((uint128_t) x, y, z, k, x_star, max_a_prime, primes, threads, is_print);
+    sum = AC_OpenMP((uint128_t) x, y, z, k, x_star, max_a_prime, primes, threads, is_print, is_compact);
   }
   else
   {
     auto primes = generate_primes<uint64_t>(max_prime);
-    sum = AC_OpenMP((uint128_t) x, y, z, k, x_star, max_a_prime, primes, threads, is_print);
+    sum = AC_OpenMP((uint128_t) x, y, z, k, x_star, max_a_prime, primes, threads, is_print, is_compact);
   }
 
   if (is_print)
@@ -35,6 +35,7 @@
 #include <SegmentedPiTable.hpp>
 #include <primecount-internal.hpp>
 #include <LoadBalancerAC.hpp>
+#include <Numa.hpp>
 #include <fast_div.hpp>
 #include <generate_primes.hpp>
 #include <gourdon.hpp>
@@ -314,7 +315,8 @@ T AC_OpenMP(T x,
             int64_t max_a_prime,
             const Primes& primes,
             int threads,
-            bool is_print)
+            bool is_print,
+            bool is_compact)
 {
   T sum = 0;
   int64_t x13 = iroot<3>(x);
@@ -340,12 +342,13 @@ T AC_OpenMP(T x,
   // PiTable is accessed much less frequently than
   // SegmentedPiTable, hence it is OK that PiTable's size
   // is fairly large and does not fit into the CPU's cache.
-  PiTable pi(max(z, max_a_prime), threads);
+  NumaReplicas<PiTable> piTables(max(z, max_a_prime), threads, is_compact);
+  const PiTable& pi0 = piTables.local();
 
-  int64_t pi_y = pi[y];
-  int64_t pi_sqrtz = pi[isqrt(z)];
-  int64_t pi_root3_xy = pi[iroot<3>(xy)];
-  int64_t pi_root3_xz = pi[iroot<3>(xz)];
+  int64_t pi_y = pi0[y];
+  int64_t pi_sqrtz = pi0[isqrt(z)];
+  int64_t pi_root3_xy = pi0[iroot<3>(xy)];
+  int64_t pi_root3_xz = pi0[iroot<3>(xz)];
   RelaxedAtomic<int64_t> min_c1(max(k, pi_root3_xz) + 1);
 
   // In order to reduce the thread creation & destruction
@@ -358,6 +361,10 @@ T AC_OpenMP(T x,
   //
   #pragma omp parallel num_threads(threads) reduction(+: sum)
   {
+    // Use the PiTable of the thread's NUMA node
+    NumaPinThread numaPin(threads);
+    const PiTable& pi = piTables.local();
+
     // C1 formula: pi[(x/z)^(1/3)] < b <= pi[pi_sqrtz]
     // There are very few iterations in this loop,
     // hence the use of an atomic loop counter (min_c1)
@@ -387,6 +394,8 @@ T AC_OpenMP(T x,
       int64_t segment_size = thread.segment_size;
       int64_t limit = low + thread.segments * segment_size;
       limit = min(limit, sqrtx);
+      double init_time = get_time();
+      T thread_sum = 0;
 
       for (; low < limit; low += segment_size)
       {
@@ -401,7 +410,10 @@ T AC_OpenMP(T x,
         // to 0 then we increase the number of segments in the
         // loadBalancer which should improve performance.
         if (low == thread.low)
+        {
           thread.secs = get_time();
+          thread.init_secs = thread.secs - init_time;
+        }
 
         T xlow = x / max(low, 1);
         T xhigh = x / high;
@@ -429,9 +441,9 @@ T AC_OpenMP(T x,
           T xp = x / prime;
 
           if (xp <= pstd::numeric_limits<uint64_t>::max())
-            sum += C2_64(xlow, xhigh, (uint64_t) xp, y, b, prime, lprimes, pi, segmentedPi);
+            thread_sum += C2_64(xlow, xhigh, (uint64_t) xp, y, b, prime, lprimes, pi, segmentedPi);
           else
-            sum += C2_128(xlow, xhigh, xp, y, b, primes, pi, segmentedPi);
+            thread_sum += C2_128(xlow, xhigh, xp, y, b, primes, pi, segmentedPi);
         }
 
         // A formula: pi[x_star] < b <= pi[x13]
@@ -441,11 +453,17 @@ T AC_OpenMP(T x,
           T xp = x / prime;
 
           if (xp <= pstd::numeric_limits<uint64_t>::max())
-            sum += A_64(xlow, xhigh, (uint64_t) xp, y, prime, lprimes, pi, segmentedPi);
+            thread_sum += A_64(xlow, xhigh, (uint64_t) xp, y, prime, lprimes, pi, segmentedPi);
           else
-            sum += A_128(xlow, xhigh, xp, y, prime, primes, pi, segmentedPi);
+            thread_sum += A_128(xlow, xhigh, xp, y, prime, primes, pi, segmentedPi);
         }
       }
+
+      // The partial sum of the current work
+      // interval is traced by get_work().
+      using ST = typename pstd::make_signed<T>::type;
+      thread.sum = (ST) thread_sum;
+      sum += thread_sum;
     }
   }
 
@@ -461,7 +479,8 @@ int64_t AC(int64_t x,
            int64_t z,
            int64_t k,
            int threads,
-           bool is_print)
+           bool is_print,
+           bool is_compact)
 {
   double time;
 
@@ -479,7 +498,7 @@ int64_t AC(int64_t x,
   int64_t max_prime = max(max_a_prime, max_c_prime);
   auto primes = generate_primes<uint32_t>(max_prime);
 
-  int64_t sum = AC_OpenMP((uint64_t) x, y, z, k, x_star, max_a_prime, primes, threads, is_print);
+  int64_t sum = AC_OpenMP((uint64_t) x, y, z, k, x_star, max_a_prime, primes, threads, is_print, is_compact);
 
   if (is_print)
     print("A + C", sum, time);
@@ -494,7 +513,8 @@ int128_t AC(int128_t x,
             int64_t z,
             int64_t k,
             int threads,
-            bool is_print)
+            bool is_print,
+            bool is_compact)
 {
   double time;
 
@@ -516,12 +536,12 @@ int128_t AC(int128_t x,
   if (max_prime <= pstd::numeric_limits<uint32_t>::max())
   {
     auto primes = generate_primes<uint32_t>(max_prime);
-    sum = AC_OpenMP((uint128_t) x, y, z, k, x_star, max_a_prime, primes, threads, is_print);
+    sum = AC_OpenMP((uint128_t) x, y, z, k, x_star, max_a_prime, primes, threads, is_print, is_compact);
   }
   else
   {
     auto primes = generate_primes<uint64_t>(max_prime);
-    sum = AC_OpenMP((uint128_t) x, y, z, k, x_star, max_a_prime, primes, threads, is_print);
+    sum = AC_OpenMP((uint128_t) x, y, z, k, x_star, max_a_prime, primes, threads, is_print, is_compact);
   }
 
   if (is_print)
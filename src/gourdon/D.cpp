@@ -13,7 +13,9 @@
 ///        each other. This implementation also uses the highly
 ///        optimized Sieve class and the FactorTableD class which is a
 ///        compressed lookup table of moebius function values,
-///        least prime factors and max prime factors.
+///        least prime factors and max prime factors. For large z
+///        the bit-packed CompactFactorTableD class is used instead
+///        if the user's --max-memory requires it.
 ///
 /// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
 ///
@@ -23,9 +25,12 @@
 
 #include <primecount-internal.hpp>
 #include <FactorTableD.hpp>
+#include <CompactFactorTableD.hpp>
 #include <PiTable.hpp>
 #include <Sieve.hpp>
+#include <ThreadSieve.hpp>
 #include <LoadBalancerS2.hpp>
+#include <Numa.hpp>
 #include <fast_div.hpp>
 #include <generate_primes.hpp>
 #include <phi_vector.hpp>
@@ -55,7 +60,8 @@ T D_thread(T x,
            const Primes& primes,
            const PiTable& pi,
            const FactorTableD& factor,
-           ThreadData& thread)
+           ThreadData& thread,
+           ThreadSieve& threadSieve)
 {
   T sum = 0;
 
@@ -72,8 +78,12 @@ T D_thread(T x,
   if (min_b > max_b)
     return 0;
 
-  Vector<int64_t> phi = phi_vector(low, max_b, primes, pi);
-  Sieve sieve(low, segment_size, max_b);
+  // Carry forward phi[] and the sieve if the thread's
+  // previous work interval ended at low.
+  bool is_contiguous = thread.is_contiguous;
+  thread.is_carried = threadSieve.init(is_contiguous, low, limit, segment_size, min_b, max_b, primes, pi);
+  Vector<int64_t>& phi = threadSieve.phi();
+  Sieve& sieve = threadSieve.sieve();
   thread.init_finished();
 
   // Segmented sieve of Eratosthenes
@@ -106,13 +116,14 @@ T D_thread(T x,
 
       min_m = factor.to_index(min_m);
       max_m = factor.to_index(max_m);
+      int64_t leaf_key = factor.leaf_key(prime, b);
 
       for (int64_t m = max_m; m > min_m; m--)
       {
         // mu[m] != 0 && 
         // lpf[m] > prime &&
         // mpf[m] <= y
-        if (prime < factor.is_leaf(m))
+        if (leaf_key < factor.is_leaf(m))
         {
           int64_t xpm = fast_div64(xp, factor.to_number(m));
           int64_t stop = xpm - low;
@@ -186,9 +197,10 @@ T D_OpenMP(T x,
            int64_t k,
            T d_approx,
            const Primes& primes,
-           const FactorTableD& factor,
+           const NumaReplicas<FactorTableD>& factors,
            int threads,
-           bool is_print)
+           bool is_print,
+           bool is_compact)
 {
   int64_t xz = x / z;
   int64_t x_star = get_x_star_gourdon(x, y);
@@ -200,11 +212,16 @@ T D_OpenMP(T x,
   threads = std::min(threads, max_threads);
   threads = ideal_num_threads(xz, threads, thread_threshold);
   LoadBalancerS2 loadBalancer(x, xz, d_approx, threads, is_print);
-  PiTable pi(y, threads);
+  NumaReplicas<PiTable> piTables(y, threads, is_compact);
 
   #pragma omp parallel num_threads(threads)
   {
+    // Use the lookup tables of the thread's NUMA node
+    NumaPinThread numaPin(threads);
+    const PiTable& pi = piTables.local();
+    const FactorTableD& factor = factors.local();
     ThreadData thread;
+    ThreadSieve threadSieve;
 
     while (loadBalancer.get_work(thread))
     {
@@ -213,12 +230,15 @@ T D_OpenMP(T x,
       using UT = typename pstd::make_unsigned<T>::type;
 
       thread.start_time();
-      UT sum = D_thread((UT) x, x_star, xz, y, z, k, primes, pi, factor, thread);
+      UT sum = D_thread((UT) x, x_star, xz, y, z, k, primes, pi, factor, thread, threadSieve);
       thread.sum = (T) sum;
       thread.stop_time();
     }
   }
 
+  if (is_print)
+    loadBalancer.print_init_time();
+
   T sum = (T) loadBalancer.get_sum();
 
   return sum;
@@ -234,7 +254,8 @@ int64_t D(int64_t x,
           int64_t k,
           int64_t d_approx,
           int threads,
-          bool is_print)
+          bool is_print,
+          bool is_compact)
 {
   double time;
 
@@ -246,9 +267,9 @@ int64_t D(int64_t x,
     time = get_time();
   }
 
-  FactorTableD<uint16_t> factor(y, z, threads);
+  NumaReplicas<FactorTableD<uint16_t>> factor(y, z, threads);
   auto primes = generate_primes<uint32_t>(y);
-  int64_t sum = D_OpenMP(x, y, z, k, d_approx, primes, factor, threads, is_print);
+  int64_t sum = D_OpenMP(x, y, z, k, d_approx, primes, factor, threads, is_print, is_compact);
 
   if (is_print)
     print("D", sum, time);
@@ -264,7 +285,8 @@ int128_t D(int128_t x,
            int64_t k,
            int128_t d_approx,
            int threads,
-           bool is_print)
+           bool is_print,
+           bool is_compact)
 {
   double time;
 
@@ -281,15 +303,25 @@ int128_t D(int128_t x,
   // uses less memory
   if (z <= FactorTableD<uint16_t>::max())
   {
-    FactorTableD<uint16_t> factor(y, z, threads);
+    NumaReplicas<FactorTableD<uint16_t>> factor(y, z, threads);
     auto primes = generate_primes<uint32_t>(y);
-    sum = D_OpenMP(x, y, z, k, d_approx, primes, factor, threads, is_print);
+    sum = D_OpenMP(x, y, z, k, d_approx, primes, factor, threads, is_print, is_compact);
+  }
+  else if (!is_compact)
+  {
+    NumaReplicas<FactorTableD<uint32_t>> factor(y, z, threads);
+    auto primes = generate_primes<int64_t>(y);
+    sum = D_OpenMP(x, y, z, k, d_approx, primes, factor, threads, is_print, is_compact);
   }
   else
   {
-    FactorTableD<uint32_t> factor(y, z, threads);
+    // If the user's --max-memory is exceeded we use a
+    // bit-packed factor table which uses 14 - 21 bits
+    // per entry (for z <= 10^14) instead of 32 bits.
+    // Unpacking the entries makes D(x, y) 10% - 20% slower.
+    NumaReplicas<CompactFactorTableD> factor(y, z, threads);
     auto primes = generate_primes<int64_t>(y);
-    sum = D_OpenMP(x, y, z, k, d_approx, primes, factor, threads, is_print);
+    sum = D_OpenMP(x, y, z, k, d_approx, primes, factor, threads, is_print, is_compact);
   }
 
   if (is_print)
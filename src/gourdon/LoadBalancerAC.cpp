@@ -4,6 +4,13 @@
 ///        computation of the A & C formulas (AC.cpp) in
 ///        Xavier Gourdon's algorithm.
 ///
+///        LoadBalancerAC is lock-free: the threads reserve work
+///        using a single atomic fetch_add on the packed state
+///        (low, segment size, number of segments). The segment
+///        size is increased by a separate controller using
+///        compare-and-swap and the status is printed by the
+///        StatusReporter thread.
+///
 ///        Load balancing is described in more detail at:
 ///        https://github.com/kimwalisch/primecount/blob/master/doc/Easy-Special-Leaves.md
 ///
@@ -21,6 +28,7 @@
 
 #include <stdint.h>
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <sstream>
 
@@ -33,10 +41,17 @@ LoadBalancerAC::LoadBalancerAC(int64_t sqrtx,
   sqrtx_(sqrtx),
   y_(y),
   threads_(threads),
-  is_print_(is_print)
+  is_print_(is_print),
+  is_trace_(is_trace()),
+  async_(get_async_context()),
+  state_(0),
+  segment_nr_(0),
+  start_time_(0),
+  print_time_(0),
+  reporting_(false)
 {
-  lock_.init(threads);
   int64_t x14 = isqrt(sqrtx);
+  int64_t segment_size;
 
   // Minimum segment size = 512 bytes.
   // This size performs well near 1e16 on my AMD EPYC 2.
@@ -53,8 +68,8 @@ LoadBalancerAC::LoadBalancerAC(int64_t sqrtx,
     // When using a single thread (and printing is disabled)
     // we can use a segment size larger than x^(1/4)
     // because load balancing is only needed for multi-threading.
-    segment_size_ = std::max(x14, l2_segment_size);
-    segments_ = ceil_div(sqrtx, segment_size_);
+    segment_size = std::max(x14, l2_segment_size);
+    segments_ = ceil_div(sqrtx, segment_size);
   }
   else
   {
@@ -62,17 +77,40 @@ LoadBalancerAC::LoadBalancerAC(int64_t sqrtx,
     // of x^(1/4). This segment fits into the CPU's cache
     // and ensures good load balancing i.e. the work is evenly
     // distributed amongst all CPU cores.
-    segment_size_ = x14;
+    segment_size = x14;
     segments_ = 1;
   }
 
-  segment_size_ = std::max(min_segment_size, segment_size_);
-  segment_size_ = SegmentedPiTable::get_segment_size(segment_size_);
-  max_segment_size_ = std::max(l2_segment_size, segment_size_);
+  segment_size = std::max(min_segment_size, segment_size);
+  segment_size = SegmentedPiTable::get_segment_size(segment_size);
+  max_segment_size_ = std::max(l2_segment_size, segment_size);
   max_segment_size_ = SegmentedPiTable::get_segment_size(max_segment_size_);
 
+  // Segment sizes after 0, 1, 2, ... 2x increases
+  for (int i = 0; i <= max_exp; i++)
+  {
+    segment_size_[i] = segment_size;
+    segment_size = std::min(segment_size * 2, max_segment_size_);
+    segment_size = SegmentedPiTable::get_segment_size(segment_size);
+  }
+
+  if (is_trace_)
+    trace_begin(TRACE_BEGIN_AC, sqrtx, threads, segment_size_[0], y);
   if (is_print_)
-    print_status(get_time());
+  {
+    print_status();
+    reporter_.reset(new StatusReporter([this] { print_status(); }));
+  }
+}
+
+int64_t LoadBalancerAC::get_segments(uint64_t state) const
+{
+  return segments_ << (state & max_exp);
+}
+
+int64_t LoadBalancerAC::get_segment_size(uint64_t state) const
+{
+  return segment_size_[(state >> exp_bits) & max_exp];
 }
 
 bool LoadBalancerAC::get_work(ThreadDataAC& thread)
@@ -80,21 +118,68 @@ bool LoadBalancerAC::get_work(ThreadDataAC& thread)
   double time = get_time();
   thread.secs = time - thread.secs;
 
-  LockGuard lockGuard(lock_);
+  // Optional trace for scripts/replay_load_balancer.cpp
+  if (is_trace_ && thread.segments > 0)
+    trace_work(thread.low, thread.segments, thread.segment_size,
+               thread.secs, thread.init_secs, thread.sum);
 
-  if (low_ >= sqrtx_)
+  // Asynchronous computation (see pi_async.cpp)
+  if (async_ && async_->is_cancelled())
     return false;
-  if (low_ == 0)
-    start_time_ = time;
 
-  int64_t remaining_dist = sqrtx_ - low_;
-  double total_secs = time - start_time_;
+  uint64_t state = state_.load(std::memory_order_relaxed);
+  if ((int64_t) (state >> low_shift) >= sqrtx_)
+    return false;
+
+  increase(thread, state, time);
+
+  // The segment size may be increased concurrently by another
+  // thread, but our reservation [low, low + dist[ always
+  // matches the segment size of our state snapshot.
+  state = state_.load(std::memory_order_relaxed);
+  int64_t segments = get_segments(state);
+  int64_t segment_size = get_segment_size(state);
+  uint64_t dist = segments * segment_size;
+  state = state_.fetch_add(dist << low_shift, std::memory_order_relaxed);
+  int64_t low = (int64_t) (state >> low_shift);
+
+  if (low >= sqrtx_)
+    return false;
+  if (low == 0)
+    start_time_.store(time, std::memory_order_relaxed);
+
+  thread.low = low;
+  thread.segments = segments;
+  thread.segment_size = segment_size;
+  segment_nr_.fetch_add(1, std::memory_order_relaxed);
+
+  // The status is printed by the reporter thread
+  if (async_)
+    report_progress(time);
+
+  return true;
+}
+
+/// Controller of the segment size, it runs before the
+/// reservation of the next work interval and uses
+/// compare-and-swap to update the packed state.
+///
+void LoadBalancerAC::increase(const ThreadDataAC& thread,
+                              uint64_t state,
+                              double time)
+{
+  int64_t low = (int64_t) (state >> low_shift);
+  int64_t remaining_dist = sqrtx_ - low;
+  int64_t segments = get_segments(state);
+  int64_t segment_size = get_segment_size(state);
+  double start_time = start_time_.load(std::memory_order_relaxed);
+  double total_secs = (start_time > 0) ? time - start_time : 0;
   double increase_threshold = std::max(0.01, total_secs / 1000);
 
   // Near the end of the computation we use a smaller
   // increase_threshold <= 1 second in order to make sure
   // all threads finish nearly at same time.
-  if (segment_size_ == max_segment_size_)
+  if (segment_size == max_segment_size_)
     increase_threshold = std::min(increase_threshold, 1.0);
 
   // Most special leaves are below y (~ x^(1/3) * log(x)).
@@ -102,55 +187,79 @@ bool LoadBalancerAC::get_work(ThreadDataAC& thread)
   // amongst all threads by using a small segment size.
   // Above y we increase the segment size (or the number of
   // segments) by 2x if the thread runtime is close to 0.
-  if (low_ > y_ &&
+  if (low > y_ &&
       thread.secs < increase_threshold &&
-      thread.segments == segments_ &&
-      thread.segment_size == segment_size_ &&
-      segments_ * segment_size_ * (threads_ * 8) < remaining_dist)
+      thread.segments == segments &&
+      thread.segment_size == segment_size &&
+      segments * segment_size * (threads_ * 8) < remaining_dist)
   {
-    int64_t increase_factor = 2;
+    uint64_t exp_mask = (1ull << low_shift) - 1;
+    uint64_t exps = state & exp_mask;
+    uint64_t inc;
 
-    if (segment_size_ >= max_segment_size_)
-      segments_ *= increase_factor;
+    if (segment_size >= max_segment_size_)
+    {
+      if ((exps & max_exp) == max_exp)
+        return;
+      inc = 1;
+    }
     else
     {
-      segment_size_ = segment_size_ * increase_factor;
-      segment_size_ = std::min(segment_size_, max_segment_size_);
-      segment_size_ = SegmentedPiTable::get_segment_size(segment_size_);
+      if (((exps >> exp_bits) & max_exp) == max_exp)
+        return;
+      inc = 1ull << exp_bits;
+    }
+
+    // Concurrent reservations only change low, if another
+    // thread has already increased the segment size (or the
+    // number of segments) we are done.
+    while (!state_.compare_exchange_weak(state, state + inc,
+                                         std::memory_order_relaxed))
+    {
+      if ((state & exp_mask) != exps)
+        break;
     }
   }
+}
 
-  if (is_print_)
-    print_status(time);
+/// Report the progress of asynchronous computations,
+/// this is done by at most one thread at a time and at
+/// most 10 times per second.
+///
+void LoadBalancerAC::report_progress(double time)
+{
+  double threshold = 0.1;
+  double print_time = print_time_.load(std::memory_order_relaxed);
 
-  thread.low = low_;
-  thread.segments = segments_;
-  thread.segment_size = segment_size_;
-  low_ = std::min(low_ + segments_ * segment_size_, sqrtx_);
-  segment_nr_++;
+  if (time - print_time < threshold ||
+      reporting_.exchange(true, std::memory_order_acquire))
+    return;
 
-  return thread.low < sqrtx_;
+  print_time_.store(time, std::memory_order_relaxed);
+  uint64_t state = state_.load(std::memory_order_relaxed);
+  int64_t low = (int64_t) (state >> low_shift);
+  low = std::min(low, sqrtx_);
+  async_->progress(get_percent(low, sqrtx_));
+  reporting_.store(false, std::memory_order_release);
 }
 
-void LoadBalancerAC::print_status(double time)
+/// Called by the status reporter thread
+void LoadBalancerAC::print_status()
 {
-  double threshold = 0.1;
+  uint64_t state = state_.load(std::memory_order_relaxed);
+  int64_t low = (int64_t) (state >> low_shift);
+  low = std::min(low, sqrtx_);
+  int64_t segment_nr = segment_nr_.load(std::memory_order_relaxed);
+  int64_t remaining_dist = sqrtx_ - low;
+  int64_t thread_dist = get_segments(state) * get_segment_size(state);
+  int64_t total_segments = ceil_div(remaining_dist, thread_dist);
+  total_segments += segment_nr;
 
-  if (time - print_time_ >= threshold)
-  {
-    print_time_ = time;
-
-    int64_t remaining_dist = sqrtx_ - low_;
-    int64_t thread_dist = segments_ * segment_size_;
-    int64_t total_segments = ceil_div(remaining_dist, thread_dist);
-    total_segments += segment_nr_;
-
-    std::ostringstream status;
-    // Clear line because total_segments may become smaller
-    status << "\r                                    "
-           << "\rSegments: " << segment_nr_ << '/' << total_segments;
-    std::cout << status.str() << std::flush;
-  }
+  std::ostringstream status;
+  // Clear line because total_segments may become smaller
+  status << "\r                                    "
+         << "\rSegments: " << segment_nr << '/' << total_segments;
+  std::cout << status.str() << std::flush;
 }
 
 } // namespace
@@ -21,7 +21,7 @@
 
 #include <gourdon.hpp>
 #include <primecount-internal.hpp>
-#include <PhiTiny.hpp>
+#include <ordinary_leaves.hpp>
 #include <generate_primes.hpp>
 #include <imath.hpp>
 #include <int128_t.hpp>
@@ -34,34 +34,6 @@ using namespace primecount;
 
 namespace {
 
-/// Recursively iterate over the square free numbers coprime
-/// to the first b primes and calculate the sum of the
-/// ordinary leaves. This algorithm is described in section
-/// 2.2 of the paper: Douglas Staple, "The Combinatorial
-/// Algorithm For Computing pi(x)", arXiv:1503.01839, 6 March
-/// 2015.
-///
-template <int MU, typename T, typename P>
-T Phi0_thread(T x,
-              int64_t z,
-              uint64_t b,
-              int64_t k,
-              T square_free,
-              const Vector<P>& primes)
-{
-  T phi0 = 0;
-
-  for (b++; b < primes.size(); b++)
-  {
-    T next = square_free * primes[b];
-    if (next > z) break;
-    phi0 += MU * phi_tiny(x / next, k);
-    phi0 += Phi0_thread<-MU>(x, z, b, k, next, primes);
-  }
-
-  return phi0;
-}
-
 /// Parallel computation of the ordinary leaves.
 /// Run time: O(z)
 /// Memory usage: O(y / log(y))
@@ -79,17 +51,10 @@ X Phi0_OpenMP(X x,
   threads = ideal_num_threads(y, threads, thread_threshold);
 
   auto primes = generate_primes<Y>(y);
-  int64_t pi_y = primes.size() - 1;
-  X phi0 = phi_tiny(x, k);
 
-  #pragma omp parallel for schedule(static, 1) num_threads(threads) reduction (+: phi0)
-  for (int64_t b = k + 1; b <= pi_y; b++)
-  {
-    phi0 -= phi_tiny(x / primes[b], k);
-    phi0 += Phi0_thread<1>(x, z, b, k, (X) primes[b], primes);
-  }
-
-  return phi0;
+  // The expensive subtrees of the small primes are split
+  // into many tasks which use dynamic scheduling.
+  return ordinary_leaves_OpenMP(x, z, k, primes, threads);
 }
 
 } // namespace
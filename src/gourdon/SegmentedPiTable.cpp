@@ -77,12 +77,12 @@ void SegmentedPiTable::init_bits()
   if (low >= high_)
     return;
 
-  primesieve::iterator it(low, high_);
+  it_.jump_to(low, high_);
   uint64_t prime = 0;
 
   // For each prime in [low, high[ set the
   // corresponding bit in the pi[x] lookup table.
-  while ((prime = it.next_prime()) < high_)
+  while ((prime = it_.next_prime()) < high_)
   {
     uint64_t p = prime - low_;
     pi_[p / 240].bits |= set_bit_[p % 240];
@@ -102,7 +102,8 @@ namespace primecount {
 int64_t Sigma(int64_t x,
               int64_t y,
               int threads,
-              bool is_print)
+              bool is_print,
+              bool is_compact)
 {
   double time;
 
@@ -119,7 +120,7 @@ int64_t Sigma(int64_t x,
   int64_t max_pix_sigma5 = y;
   int64_t max_pix_sigma6 = isqrt(x / x_star);
   int64_t max_pix = max3(max_pix_sigma4, max_pix_sigma5, max_pix_sigma6);
-  PiTable pi(max_pix, threads);
+  PiTable pi(max_pix, threads, is_compact);
 
   int64_t a = pi[y];
   int64_t b = pi[iroot<3>(x)];
@@ -143,7 +144,8 @@ int64_t Sigma(int64_t x,
 int128_t Sigma(int128_t x,
                int64_t y,
                int threads,
-               bool is_print)
+               bool is_print,
+               bool is_compact)
 {
   double time;
 
@@ -160,7 +162,7 @@ int128_t Sigma(int128_t x,
   int64_t max_pix_sigma5 = y;
   int64_t max_pix_sigma6 = isqrt(x / x_star);
   int64_t max_pix = max3(max_pix_sigma4, max_pix_sigma5, max_pix_sigma6);
-  PiTable pi(max_pix, threads);
+  PiTable pi(max_pix, threads, is_compact);
 
   int128_t a = pi[y];
   int128_t b = pi[iroot<3>(x)];
@@ -0,0 +1,377 @@
+///
+/// @file  pi_deadline.cpp
+/// @brief Compute pi(x) using Xavier Gourdon's algorithm within a
+///        time budget. If the computation cannot finish in time
+///        RiemannR(x) is returned instead, together with the
+///        predicted run time of the exact computation.
+///
+///        The run time is predicted using a cost model: the run
+///        times of the formulas (Sigma, Phi0, AC, B, D) are
+///        measured once for x_ref and then extrapolated using
+///        their run time complexity. During the computation the
+///        prediction is corrected using the measured run times of
+///        Sigma and Phi0 and using the throughput of the load
+///        balancers (LoadBalancerP2 and LoadBalancerS2). If the
+///        predicted end of the computation is after the deadline,
+///        the computation is aborted using the cancellation
+///        mechanism of AsyncContext.hpp and RiemannR(x) is
+///        returned.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <gourdon.hpp>
+#include <primecount.hpp>
+#include <primecount-internal.hpp>
+#include <AsyncContext.hpp>
+#include <imath.hpp>
+#include <int128_t.hpp>
+#include <macros.hpp>
+#include <PhiTiny.hpp>
+#include <result_cache.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace primecount;
+
+enum Stage
+{
+  STAGE_SIGMA,
+  STAGE_PHI0,
+  STAGE_AC,
+  STAGE_B,
+  STAGE_D,
+  STAGES
+};
+
+/// For x < x_ref pi(x) is computed without a deadline,
+/// this takes less than 0.1 seconds on current CPUs.
+const int64_t x_ref = (int64_t) 1e12;
+
+/// The load balancers' progress is only used for
+/// extrapolation once a formula is 5% completed.
+/// LoadBalancerAC's progress is not used as the AC
+/// segments near 0 are much more expensive than the
+/// segments near sqrt(x).
+const double min_percent = 5;
+
+/// Run time complexity of the formulas of Gourdon's
+/// algorithm, only the ratio cost(x) / cost(x_ref) is
+/// used. Sigma and Phi0 run much faster than the other
+/// formulas and their run time grows more slowly.
+///
+double cost(int stage, double x)
+{
+  double logx = std::log(x);
+
+  if (stage == STAGE_SIGMA ||
+      stage == STAGE_PHI0)
+    return std::sqrt(x) / logx;
+  else
+    return std::pow(x, 2.0 / 3.0) / (logx * logx);
+}
+
+class CostModel
+{
+public:
+  CostModel(const double* predicted, double deadline)
+    : deadline_(deadline)
+  {
+    std::copy_n(predicted, STAGES, predicted_);
+    context_.set_callback([this](double percent) {
+      progress(percent); });
+  }
+
+  AsyncContext& context()
+  {
+    return context_;
+  }
+
+  double seconds(int stage) const
+  {
+    return elapsed_[stage];
+  }
+
+  /// Start the next formula, returns false if the
+  /// computation cannot finish before the deadline.
+  ///
+  bool start(int stage)
+  {
+    if (context_.is_cancelled())
+      return false;
+
+    double time = get_time();
+
+    if (stage_ >= 0)
+      elapsed_[stage_] = time - stage_time_;
+
+    stage_ = stage;
+    stage_time_ = time;
+    percent_ = 0;
+
+    if (time + remaining(time) > deadline_)
+      context_.cancel();
+
+    return !context_.is_cancelled();
+  }
+
+  /// Returns false if the computation has been aborted
+  bool finish()
+  {
+    if (context_.is_cancelled())
+      return false;
+
+    elapsed_[stage_] = get_time() - stage_time_;
+    stage_ = STAGES;
+    return true;
+  }
+
+  /// Predicted run time of the remaining formulas
+  double remaining(double time) const
+  {
+    double done = 0;
+    double predicted = 0;
+    double remaining = 0;
+
+    for (int i = 0; i < std::min(stage_, (int) STAGES); i++)
+    {
+      done += elapsed_[i];
+      predicted += predicted_[i];
+    }
+
+    // Correct the prediction using the measured
+    // run times of the completed formulas.
+    double factor = 1;
+    if (predicted > 0 && done > 0)
+      factor = done / predicted;
+
+    for (int i = stage_ + 1; i < STAGES; i++)
+      remaining += predicted_[i] * factor;
+
+    if (stage_ >= 0 && stage_ < STAGES)
+    {
+      double secs = time - stage_time_;
+      double stage_secs = predicted_[stage_] * factor;
+
+      // Extrapolate the load balancer's throughput
+      if (percent_ >= min_percent &&
+          stage_ != STAGE_AC)
+        stage_secs = secs * 100 / percent_;
+
+      remaining += std::max(stage_secs - secs, 0.0);
+    }
+
+    return remaining;
+  }
+
+  /// Predicted run time of the exact computation
+  double total() const
+  {
+    double time = get_time();
+    double done = 0;
+
+    for (int i = 0; i < std::min(stage_, (int) STAGES); i++)
+      done += elapsed_[i];
+    if (stage_ >= 0 && stage_ < STAGES)
+      done += time - stage_time_;
+
+    return done + remaining(time);
+  }
+
+private:
+  /// Called by the load balancers (at most 10
+  /// times per second) inside of their critical
+  /// section, hence never simultaneously.
+  ///
+  void progress(double percent)
+  {
+    double time = get_time();
+    percent_ = percent;
+
+    if (time > deadline_ ||
+        time + remaining(time) > deadline_)
+      context_.cancel();
+  }
+
+  AsyncContext context_;
+  double predicted_[STAGES] = { 0 };
+  double elapsed_[STAGES] = { 0 };
+  double deadline_ = 0;
+  double stage_time_ = 0;
+  double percent_ = 0;
+  int stage_ = -1;
+};
+
+/// Same as pi_gourdon_64(x) and pi_gourdon_128(x) but the
+/// formulas are started by the cost model which aborts the
+/// computation if it cannot finish before the deadline.
+/// @return pi(x) or -1 if the computation has been aborted.
+///
+template <typename T>
+T pi_gourdon_deadline(T x, int threads, CostModel& model)
+{
+  auto alpha = get_alpha_gourdon(x);
+  double alpha_y = alpha.first;
+  double alpha_z = alpha.second;
+  maxint_t limit = get_max_x(alpha_y);
+
+  if_unlikely(x > limit)
+    throw primecount_error("pi(x): x must be <= " + to_string(limit));
+
+  auto yz = get_yz_gourdon(x, alpha_y, alpha_z);
+  int64_t y = yz.first;
+  int64_t z = yz.second;
+  int64_t k = PhiTiny::get_k(x);
+
+  bool is_compact = is_compact_pi_table_gourdon(x, y, z, threads);
+  threads = max_memory_threads_gourdon(x, y, z, threads, is_compact);
+  // The nested pi(x) computations of Sigma and B
+  // (pi_noprint()) do not see the CostModel's context.
+  AsyncContextGuard guard(&model.context());
+  bool is_print = false;
+
+  if (!model.start(STAGE_SIGMA))
+    return -1;
+  T sigma = Sigma(x, y, threads, is_print, is_compact);
+  if (!model.start(STAGE_PHI0))
+    return -1;
+  T phi0 = Phi0(x, y, z, k, threads, is_print);
+  if (!model.start(STAGE_AC))
+    return -1;
+  T ac = AC(x, y, z, k, threads, is_print, is_compact);
+  if (!model.start(STAGE_B))
+    return -1;
+  T b = B(x, y, threads, is_print);
+  if (!model.start(STAGE_D))
+    return -1;
+  T d_approx = D_approx(x, sigma, phi0, ac, b);
+  T d = D(x, y, z, k, d_approx, threads, is_print, is_compact);
+  if (!model.finish())
+    return -1;
+
+  return ac - b + d + phi0 + sigma;
+}
+
+/// Measure the run times of the formulas for x_ref.
+/// The measurements are cached per number of threads.
+/// Note that for x_ref fewer threads may be used than
+/// for large x, hence the predicted run time is rather
+/// too large which is corrected during the computation.
+///
+void calibrate(int threads, double* seconds)
+{
+  static std::mutex mutex;
+  static std::map<int, std::vector<double>> cache;
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto iter = cache.find(threads);
+  if (iter == cache.end())
+  {
+    double predicted[STAGES] = { 0 };
+    double deadline = std::numeric_limits<double>::infinity();
+    CostModel model(predicted, deadline);
+    pi_gourdon_deadline(x_ref, threads, model);
+    std::vector<double> secs(STAGES);
+
+    for (int i = 0; i < STAGES; i++)
+      secs[i] = model.seconds(i);
+
+    iter = cache.emplace(threads, secs).first;
+  }
+
+  std::copy_n(iter->second.begin(), STAGES, seconds);
+}
+
+} // namespace
+
+namespace primecount {
+
+DeadlineResult pi_deadline(const std::string& x, double seconds)
+{
+  maxint_t n = to_maxint(x);
+  int threads = get_num_threads();
+  double time = get_time();
+  DeadlineResult res;
+  maxint_t pix = -1;
+
+  if (n >= min_cached_x &&
+      result_cache_find(CACHE_PI, n, 0, pix))
+  {
+    res.pix = to_string(pix);
+    res.is_exact = true;
+    res.seconds = get_time() - time;
+    return res;
+  }
+
+  if (n < x_ref)
+  {
+    res.pix = to_string(pi(n, threads));
+    res.is_exact = true;
+    res.seconds = get_time() - time;
+    return res;
+  }
+
+  // The one-time calibration (see calibrate()) is
+  // not charged against the user's time budget.
+  double predicted[STAGES];
+  double calibrate_time = get_time();
+  calibrate(threads, predicted);
+  time += get_time() - calibrate_time;
+
+  for (int i = 0; i < STAGES; i++)
+    predicted[i] *= cost(i, (double) n) / cost(i, (double) x_ref);
+
+  CostModel model(predicted, time + seconds);
+
+  try
+  {
+    if (n <= pstd::numeric_limits<int64_t>::max())
+      pix = pi_gourdon_deadline((int64_t) n, threads, model);
+    else
+    {
+#if defined(HAVE_INT128_T)
+      pix = pi_gourdon_deadline((int128_t) n, threads, model);
+#endif
+    }
+  }
+  catch (primecount_error&)
+  {
+    // An aborted computation always
+    // returns the RiemannR(x) fallback.
+    if (!model.context().is_cancelled())
+      throw;
+    pix = -1;
+  }
+
+  if (pix >= 0)
+  {
+    if (n >= min_cached_x && is_result_cache())
+      result_cache_insert(CACHE_PI, n, 0, pix);
+
+    res.pix = to_string(pix);
+    res.is_exact = true;
+    res.seconds = get_time() - time;
+  }
+  else
+  {
+    res.pix = to_string(RiemannR(n));
+    res.is_exact = false;
+    res.seconds = model.total();
+  }
+
+  return res;
+}
+
+} // namespace
@@ -16,6 +16,7 @@
 ///
 
 #include <gourdon.hpp>
+#include <AsyncContext.hpp>
 #include <primecount.hpp>
 #include <primecount-internal.hpp>
 #include <imath.hpp>
@@ -44,22 +45,16 @@ int64_t pi_gourdon_64(int64_t x,
   auto alpha = get_alpha_gourdon(x);
   double alpha_y = alpha.first;
   double alpha_z = alpha.second;
-  int64_t x13 = iroot<3>(x);
-  int64_t sqrtx = isqrt(x);
-  int64_t y = (int64_t)(x13 * alpha_y);
-
-  // x^(1/3) < y < x^(1/2)
-  y = std::max(y, x13 + 1);
-  y = std::min(y, sqrtx - 1);
-  y = std::max(y, (int64_t) 1);
-
+  auto yz = get_yz_gourdon(x, alpha_y, alpha_z);
+  int64_t y = yz.first;
+  int64_t z = yz.second;
   int64_t k = PhiTiny::get_k(x);
-  int64_t z = (int64_t)(y * alpha_z);
 
-  // y <= z < x^(1/2)
-  z = std::max(z, y);
-  z = std::min(z, sqrtx - 1);
-  z = std::max(z, (int64_t) 1);
+  // Use the compact PiTable layout and reduce the
+  // number of threads if the predicted memory
+  // usage exceeds the user's --max-memory.
+  bool is_compact = is_compact_pi_table_gourdon(x, y, z, threads);
+  threads = max_memory_threads_gourdon(x, y, z, threads, is_compact);
 
   if (is_print)
   {
@@ -79,12 +74,19 @@ int64_t pi_gourdon_64(int64_t x,
   // the CPU and memory (i.e. the B algorithm) we would overload
   // both the CPU and operating system.
 
-  int64_t sigma = Sigma(x, y, threads, is_print);
+  // A cancelled pi_async() computation
+  // stops before the next formula.
+  int64_t sigma = Sigma(x, y, threads, is_print, is_compact);
+  check_cancelled();
   int64_t phi0 = Phi0(x, y, z, k, threads, is_print);
-  int64_t ac = AC(x, y, z, k, threads, is_print);
+  check_cancelled();
+  int64_t ac = AC(x, y, z, k, threads, is_print, is_compact);
+  check_cancelled();
   int64_t b = B(x, y, threads, is_print);
+  check_cancelled();
   int64_t d_approx = D_approx(x, sigma, phi0, ac, b);
-  int64_t d = D(x, y, z, k, d_approx, threads, is_print);
+  int64_t d = D(x, y, z, k, d_approx, threads, is_print, is_compact);
+  check_cancelled();
   int64_t sum = ac - b + d + phi0 + sigma;
 
   return sum;
@@ -112,22 +114,16 @@ int128_t pi_gourdon_128(int128_t x,
   if_unlikely(x > limit)
     throw primecount_error("pi(x): x must be <= " + to_string(limit));
 
-  int64_t x13 = iroot<3>(x);
-  int64_t sqrtx = isqrt(x);
-  int64_t y = (int64_t)(x13 * alpha_y);
-
-  // x^(1/3) < y < x^(1/2)
-  y = std::max(y, x13 + 1);
-  y = std::min(y, sqrtx - 1);
-  y = std::max(y, (int64_t) 1);
-
+  auto yz = get_yz_gourdon(x, alpha_y, alpha_z);
+  int64_t y = yz.first;
+  int64_t z = yz.second;
   int64_t k = PhiTiny::get_k(x);
-  int64_t z = (int64_t)(y * alpha_z);
 
-  // y <= z < x^(1/2)
-  z = std::max(z, y);
-  z = std::min(z, sqrtx - 1);
-  z = std::max(z, (int64_t) 1);
+  // Use the compact PiTable layout and reduce the
+  // number of threads if the predicted memory
+  // usage exceeds the user's --max-memory.
+  bool is_compact = is_compact_pi_table_gourdon(x, y, z, threads);
+  threads = max_memory_threads_gourdon(x, y, z, threads, is_compact);
 
   if (is_print)
   {
@@ -147,12 +143,19 @@ int128_t pi_gourdon_128(int128_t x,
   // the CPU and memory (i.e. the B algorithm) we would overload
   // both the CPU and operating system.
 
-  int128_t sigma = Sigma(x, y, threads, is_print);
+  // A cancelled pi_async() computation
+  // stops before the next formula.
+  int128_t sigma = Sigma(x, y, threads, is_print, is_compact);
+  check_cancelled();
   int128_t phi0 = Phi0(x, y, z, k, threads, is_print);
-  int128_t ac = AC(x, y, z, k, threads, is_print);
+  check_cancelled();
+  int128_t ac = AC(x, y, z, k, threads, is_print, is_compact);
+  check_cancelled();
   int128_t b = B(x, y, threads, is_print);
+  check_cancelled();
   int128_t d_approx = D_approx(x, sigma, phi0, ac, b);
-  int128_t d = D(x, y, z, k, d_approx, threads, is_print);
+  int128_t d = D(x, y, z, k, d_approx, threads, is_print, is_compact);
+  check_cancelled();
   int128_t sum = ac - b + d + phi0 + sigma;
 
   return sum;
@@ -8,6 +8,10 @@
 ///        counting the number of unsieved elements but instead counts
 ///        the number of unsieved elements directly from the sieve
 ///        array using the POPCNT instruction which is much faster.
+///        Like S2_hard.cpp this implementation uses the compressed
+///        FactorTable and PiTable lookup tables and supports 128-bit
+///        x, it is used to verify the results of the Deleglise-Rivat
+///        and Gourdon algorithms.
 ///
 ///        Lagarias-Miller-Odlyzko formula:
 ///        pi(x) = pi(y) + S1(x, a) + S2(x, a) - 1 - P2(x, a)
@@ -18,7 +22,7 @@
 ///        method, Revista do DETUA, vol. 4, no. 6, March 2006,
 ///        pp. 759-768.
 ///
-/// Copyright (C) 2023 Kim Walisch, <kim.walisch@gmail.com>
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
 ///
 /// This file is distributed under the BSD License. See the COPYING
 /// file in the top level directory.
@@ -26,11 +30,15 @@
 
 #include <primecount-internal.hpp>
 #include <Sieve.hpp>
+#include <ThreadSieve.hpp>
+#include <FactorTable.hpp>
+#include <fast_div.hpp>
 #include <generate_primes.hpp>
 #include <phi_vector.hpp>
 #include <LoadBalancerS2.hpp>
 #include <min.hpp>
 #include <imath.hpp>
+#include <int128_t.hpp>
 #include <PhiTiny.hpp>
 #include <PiTable.hpp>
 #include <print.hpp>
@@ -38,6 +46,7 @@
 #include <S.hpp>
 
 #include <stdint.h>
+#include <string>
 
 using namespace primecount;
 
@@ -46,17 +55,18 @@ namespace {
 /// Compute the S2 contribution of the interval
 /// [low, low + segments * segment_size[.
 ///
-int64_t S2_thread(int64_t x,
-                  int64_t y,
-                  int64_t z,
-                  int64_t c,
-                  const PiTable& pi,
-                  const Vector<uint32_t>& primes,
-                  const Vector<int32_t>& lpf,
-                  const Vector<int32_t>& mu,
-                  ThreadData& thread)
+template <typename T, typename Primes, typename FactorTable>
+T S2_thread(T x,
+            int64_t y,
+            int64_t z,
+            int64_t c,
+            const PiTable& pi,
+            const Primes& primes,
+            const FactorTable& factor,
+            ThreadData& thread,
+            ThreadSieve& threadSieve)
 {
-  int64_t sum = 0;
+  T sum = 0;
   int64_t low = thread.low;
   int64_t low1 = max(low, 1);
   int64_t segments = thread.segments;
@@ -70,8 +80,12 @@ int64_t S2_thread(int64_t x,
   if (min_b > max_b)
     return 0;
 
-  Vector<int64_t> phi = phi_vector(low, max_b, primes, pi);
-  Sieve sieve(low, segment_size, max_b);
+  // Carry forward phi[] and the sieve if the thread's
+  // previous work interval ended at low.
+  bool is_contiguous = thread.is_contiguous;
+  thread.is_carried = threadSieve.init(is_contiguous, low, limit, segment_size, min_b, max_b, primes, pi);
+  Vector<int64_t>& phi = threadSieve.phi();
+  Sieve& sieve = threadSieve.sieve();
   thread.init_finished();
 
   // segmented sieve of Eratosthenes
@@ -90,23 +104,30 @@ int64_t S2_thread(int64_t x,
     // Find all special leaves in the current segment that are
     // composed of a prime and a square free number:
     // low <= x / (primes[b] * m) < high
-    for (; b <= min(pi_sqrty, max_b); b++)
+    for (int64_t last = min(pi_sqrty, max_b); b <= last; b++)
     {
       int64_t prime = primes[b];
-      int64_t min_m = max(x / (prime * high), y / prime);
-      int64_t max_m = min(x / (prime * low1), y);
+      T xp = x / prime;
+      int64_t xp_high = min(fast_div(xp, high), y);
+      int64_t min_m = max(xp_high, y / prime);
+      int64_t max_m = min(fast_div(xp, low1), y);
 
       if (prime >= max_m)
         goto next_segment;
 
+      min_m = factor.to_index(min_m);
+      max_m = factor.to_index(max_m);
+
       for (int64_t m = max_m; m > min_m; m--)
       {
-        if (mu[m] != 0 && prime < lpf[m])
+        // mu(m) != 0 && prime < lpf(m)
+        if (prime < factor.mu_lpf(m))
         {
-          int64_t xpm = x / (prime * m);
+          int64_t xpm = fast_div64(xp, factor.to_number(m));
           int64_t stop = xpm - low;
           int64_t phi_xpm = phi[b] + sieve.count(stop);
-          sum -= mu[m] * phi_xpm;
+          int64_t mu_m = factor.mu(m);
+          sum -= mu_m * phi_xpm;
         }
       }
 
@@ -121,15 +142,18 @@ int64_t S2_thread(int64_t x,
     for (; b <= max_b; b++)
     {
       int64_t prime = primes[b];
-      int64_t l = pi[min(x / (prime * low1), y)];
-      int64_t min_m = max(x / (prime * high), prime);
+      T xp = x / prime;
+      int64_t xp_low = min(fast_div(xp, low1), y);
+      int64_t xp_high = min(fast_div(xp, high), y);
+      int64_t l = pi[xp_low];
+      int64_t min_m = max(xp_high, prime);
 
       if (prime >= primes[l])
         goto next_segment;
 
       for (; primes[l] > min_m; l--)
       {
-        int64_t xpq = x / (prime * primes[l]);
+        int64_t xpq = fast_div64(xp, primes[l]);
         int64_t stop = xpq - low;
         int64_t phi_xpq = phi[b] + sieve.count(stop);
         sum += phi_xpq;
@@ -145,7 +169,7 @@ int64_t S2_thread(int64_t x,
   return sum;
 }
 
-/// Calculate the contribution of thes pecial leaves.
+/// Calculate the contribution of the special leaves.
 ///
 /// This is a parallel S2(x, y) implementation with advanced load
 /// balancing. As most special leaves tend to be in the first segments
@@ -163,26 +187,17 @@ int64_t S2_thread(int64_t x,
 /// (this is done in S2_thread(x, y)) every time the thread starts a
 /// new computation.
 ///
-int64_t S2(int64_t x,
-           int64_t y,
-           int64_t z,
-           int64_t c,
-           int64_t s2_approx,
-           const Vector<uint32_t>& primes,
-           const Vector<int32_t>& lpf,
-           const Vector<int32_t>& mu,
-           int threads,
-           bool is_print)
+template <typename T, typename Primes, typename FactorTable>
+T S2_OpenMP(T x,
+            int64_t y,
+            int64_t z,
+            int64_t c,
+            T s2_approx,
+            const Primes& primes,
+            const FactorTable& factor,
+            int threads,
+            bool is_print)
 {
-  double time;
-
-  if (is_print)
-  {
-    print("");
-    print("=== S2(x, y) ===");
-    time = get_time();
-  }
-
   // These load balancing settings work well on my
   // dual-socket AMD EPYC 7642 server with 192 CPU cores.
   int64_t thread_threshold = 1 << 20;
@@ -195,19 +210,25 @@ int64_t S2(int64_t x,
   #pragma omp parallel num_threads(threads)
   {
     ThreadData thread;
+    ThreadSieve threadSieve;
 
     while (loadBalancer.get_work(thread))
     {
+      // Unsigned integer division is usually slightly
+      // faster than signed integer division
+      using UT = typename pstd::make_unsigned<T>::type;
+
       thread.start_time();
-      thread.sum = S2_thread(x, y, z, c, pi, primes, lpf, mu, thread);
+      UT sum = S2_thread((UT) x, y, z, c, pi, primes, factor, thread, threadSieve);
+      thread.sum = (T) sum;
       thread.stop_time();
     }
   }
 
-  int64_t sum = (int64_t) loadBalancer.get_sum();
-
   if (is_print)
-    print("S2", sum, time);
+    loadBalancer.print_init_time();
+
+  T sum = (T) loadBalancer.get_sum();
 
   return sum;
 }
@@ -242,19 +263,107 @@ int64_t pi_lmo_parallel(int64_t x,
     print(x, y, z, c, threads);
   }
 
+  FactorTable<uint16_t> factor(y, threads);
   auto primes = generate_primes<uint32_t>(y);
-  auto lpf = generate_lpf(y);
-  auto mu = generate_moebius(y);
 
   int64_t pi_y = primes.size() - 1;
   int64_t p2 = P2(x, y, pi_y, threads, is_print);
   int64_t s1 = S1(x, y, c, threads, is_print);
   int64_t s2_approx = S2_approx(x, pi_y, p2, s1);
-  int64_t s2 = S2(x, y, z, c, s2_approx, primes, lpf, mu, threads, is_print);
+  double time;
+
+  if (is_print)
+  {
+    print("");
+    print("=== S2(x, y) ===");
+    time = get_time();
+  }
+
+  int64_t s2 = S2_OpenMP(x, y, z, c, s2_approx, primes, factor, threads, is_print);
+
+  if (is_print)
+    print("S2", s2, time);
+
   int64_t phi = s1 + s2;
   int64_t sum = phi + pi_y - 1 - p2;
 
   return sum;
 }
 
+#ifdef HAVE_INT128_T
+
+/// Calculate the number of primes below x using the
+/// Lagarias-Miller-Odlyzko algorithm.
+/// Run time: O(x^(2/3) / log x)
+/// Memory usage: O(x^(1/3) * (log x)^2)
+///
+/// FactorTable<uint32_t> is only used for huge x with
+/// y > FactorTable<uint16_t>::max(), is_factor32 = true
+/// forces using it for smaller x (for testing).
+///
+int128_t pi_lmo_parallel_128(int128_t x,
+                             int threads,
+                             bool is_print,
+                             bool is_factor32)
+{
+  if (x < 2)
+    return 0;
+
+  double alpha = get_alpha_lmo(x);
+  maxint_t limit = get_max_x(alpha);
+
+  if_unlikely(x > limit)
+    throw primecount_error("pi_lmo_parallel(x): x must be <= " + to_string(limit));
+
+  int64_t y = (int64_t) (iroot<3>(x) * alpha);
+  int64_t z = (int64_t) (x / y);
+  int64_t c = PhiTiny::get_c(y);
+
+  if (is_print)
+  {
+    print("");
+    print("=== pi_lmo_parallel_128(x) ===");
+    print("pi(x) = S1 + S2 + pi(y) - 1 - P2");
+    print(x, y, z, c, threads);
+  }
+
+  int64_t pi_y = pi_noprint(y, threads);
+  int128_t p2 = P2(x, y, pi_y, threads, is_print);
+  int128_t s1 = S1(x, y, c, threads, is_print);
+  int128_t s2_approx = S2_approx(x, pi_y, p2, s1);
+  int128_t s2;
+  double time;
+
+  if (is_print)
+  {
+    print("");
+    print("=== S2(x, y) ===");
+    time = get_time();
+  }
+
+  // uses less memory
+  if (y <= FactorTable<uint16_t>::max() && !is_factor32)
+  {
+    FactorTable<uint16_t> factor(y, threads);
+    auto primes = generate_primes<uint32_t>(y);
+    s2 = S2_OpenMP(x, y, z, c, s2_approx, primes, factor, threads, is_print);
+  }
+  else
+  {
+    FactorTable<uint32_t> factor(y, threads);
+    auto primes = generate_primes<int64_t>(y);
+    s2 = S2_OpenMP(x, y, z, c, s2_approx, primes, factor, threads, is_print);
+  }
+
+  if (is_print)
+    print("S2", s2, time);
+
+  int128_t phi = s1 + s2;
+  int128_t sum = phi + pi_y - 1 - p2;
+
+  return sum;
+}
+
+#endif
+
 } // namespace
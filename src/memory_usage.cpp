@@ -0,0 +1,527 @@
+///
+/// @file  memory_usage.cpp
+/// @brief Predict the peak memory usage of Xavier Gourdon's
+///        algorithm and of the Deleglise-Rivat algorithm. The
+///        formulas of both algorithms are computed one after the
+///        other and each formula frees its lookup tables before
+///        the next formula starts. Hence the peak memory usage is
+///        the maximum memory usage of the individual formulas.
+///
+///        The memory usage of each formula is the sum of its
+///        shared lookup tables (PiTable, FactorTable, primes) and
+///        of its per thread data structures (Sieve, phi vector,
+///        SegmentedPiTable, primesieve::iterator). The sizes
+///        below must be kept in sync with the corresponding
+///        data structures.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primecount.hpp>
+#include <primecount-internal.hpp>
+#include <primecount-config.hpp>
+#include <BaseFactorTable.hpp>
+#include <Numa.hpp>
+#include <PhiTiny.hpp>
+#include <imath.hpp>
+#include <int128_t.hpp>
+#include <min.hpp>
+#include <print.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+using namespace primecount;
+
+/// Max memory usage in bytes, -1 = unlimited
+double max_memory_ = -1;
+
+/// Memory usage of the individual formulas of
+/// an algorithm, the peak memory usage is the
+/// max of the individual formulas.
+struct Formula
+{
+  const char* name;
+  double bytes;
+};
+
+/// Approximate number of primes <= n
+double pi_approx(int64_t n)
+{
+  return (double) Li(max(n, 2)) + 1;
+}
+
+/// generate_primes<T>(n)
+double primes_bytes(int64_t n)
+{
+  double bytes = (n <= pstd::numeric_limits<uint32_t>::max()) ? 4 : 8;
+  return pi_approx(n) * bytes;
+}
+
+/// FactorTable & FactorTableD only store numbers
+/// coprime to 2, 3, 5, 7 and 11.
+///
+double factor_entries(int64_t n)
+{
+  return (double) BaseFactorTable::to_index(max(n, 1)) + 1;
+}
+
+/// FactorTable<uint16_t>::max()
+double max_uint16_factor()
+{
+  return 65534.0 * 65534.0 - 1;
+}
+
+/// FactorTable<uint16_t> or FactorTable<uint32_t>
+double FactorTable_bytes(int64_t y)
+{
+  double bytes = (y <= max_uint16_factor()) ? 2 : 4;
+  return factor_entries(y) * bytes;
+}
+
+/// FactorTableD<uint16_t>, FactorTableD<uint32_t>
+/// or CompactFactorTableD (if is_compact).
+///
+double FactorTableD_bytes(int64_t z, bool is_compact)
+{
+  if (z <= max_uint16_factor())
+    return factor_entries(z) * 2;
+  if (!is_compact)
+    return factor_entries(z) * 4;
+
+  // CompactFactorTableD stores 2 * pi[lpf] + 1
+  // using the minimal number of bits.
+  int64_t max_leaf = 2 * (int64_t) pi_approx(isqrt(z)) + 2;
+  int bits = ilog2(max_leaf) + 1;
+  return factor_entries(z) * bits / 8;
+}
+
+/// Sieve (used in S2_hard and D) + phi vector
+double Sieve_bytes(int64_t sieve_limit, int64_t max_b)
+{
+  int64_t sieve_bytes = L1D_CACHE_SIZE * 2;
+  int64_t segment_size = max(sieve_bytes * 30, isqrt(sieve_limit));
+  double sieve = segment_size / 30.0;
+  double counter = sieve / 32;
+  double wheel = max_b * 8.0;
+  double phi = max_b * 8.0;
+  return sieve + counter + wheel + phi;
+}
+
+/// SegmentedPiTable uses 16 bytes per 240 numbers
+double SegmentedPiTable_bytes(maxint_t x)
+{
+  int64_t x14 = iroot<4>(x);
+  int64_t l2_segment_size = L2_CACHE_SIZE * 15;
+  int64_t segment_size = max(x14, l2_segment_size);
+  return segment_size / 15.0;
+}
+
+/// primesieve::iterator uses a sieve array that
+/// fits into the CPU's L2 cache and it stores the
+/// sieving primes <= sqrt(stop).
+///
+double iterator_bytes(int64_t stop)
+{
+  return L2_CACHE_SIZE + pi_approx(isqrt(stop)) * 8.0;
+}
+
+/// With the NUMA_REPLICATE policy each NUMA node gets
+/// its own copy of the lookup tables in AC.cpp & D.cpp.
+double numa_copies()
+{
+  if (get_numa_policy() == NUMA_REPLICATE)
+    return numa_nodes();
+  else
+    return 1;
+}
+
+double peak(const Formula* formulas, int size)
+{
+  double bytes = 0;
+  for (int i = 0; i < size; i++)
+    bytes = std::max(bytes, formulas[i].bytes);
+  return bytes;
+}
+
+/// Estimate memory usage of Xavier Gourdon's algorithm
+void gourdon_formulas(maxint_t x,
+                      int64_t y,
+                      int64_t z,
+                      int threads,
+                      bool is_compact,
+                      Formula* formulas)
+{
+  y = max(y, 1);
+  z = max(z, 1);
+  threads = max(threads, 1);
+  int64_t x_star = get_x_star_gourdon(x, y);
+  int64_t xy = (int64_t)(x / y);
+  int64_t xz = (int64_t)(x / z);
+
+  // Sigma.cpp
+  int64_t max_pix_sigma4 = (int64_t)(x / ((maxint_t) x_star * y));
+  int64_t max_pix_sigma6 = (int64_t) isqrt(x / x_star);
+  int64_t max_pix = max3(max_pix_sigma4, y, max_pix_sigma6);
+  formulas[0] = { "Sigma", PiTable_bytes(max_pix, is_compact) };
+
+  // Phi0.cpp
+  formulas[1] = { "Phi0", primes_bytes(y) };
+
+  // AC.cpp, with libdivide (default) each prime
+  // also requires a branchfree_divider of 16 bytes.
+  int64_t max_a_prime = (int64_t) isqrt(x / x_star);
+  int64_t max_prime = max(max_a_prime, y);
+  double ac = PiTable_bytes(max(z, max_a_prime), is_compact) * numa_copies();
+  ac += primes_bytes(max_prime);
+  ac += pi_approx(max_prime) * 16;
+  ac += threads * SegmentedPiTable_bytes(x);
+  formulas[2] = { "AC", ac };
+
+  // B.cpp, each thread uses 2 primesieve::iterators
+  formulas[3] = { "B", threads * 2 * iterator_bytes(xy) };
+
+  // D.cpp
+  int64_t max_b = (int64_t) pi_approx(x_star);
+  double d = FactorTableD_bytes(z, is_compact) * numa_copies();
+  d += primes_bytes(y);
+  d += PiTable_bytes(y, is_compact) * numa_copies();
+  d += threads * Sieve_bytes(xz, max_b);
+  formulas[4] = { "D", d };
+}
+
+/// Estimate memory usage of the Deleglise-Rivat algorithm
+void deleglise_rivat_formulas(maxint_t x,
+                              int64_t y,
+                              int threads,
+                              bool is_compact,
+                              Formula* formulas)
+{
+  y = max(y, 1);
+  threads = max(threads, 1);
+  int64_t z = (int64_t)(x / y);
+
+  // P2.cpp, each thread uses 2 primesieve::iterators
+  formulas[0] = { "P2", threads * 2 * iterator_bytes(z) };
+
+  // S1.cpp
+  formulas[1] = { "S1", primes_bytes(y) };
+
+  // S2_trivial.cpp
+  formulas[2] = { "S2_trivial", PiTable_bytes(y, is_compact) };
+
+  // S2_easy.cpp, with libdivide (default) each prime
+  // also requires a branchfree_divider of 16 bytes.
+  double s2_easy = PiTable_bytes(y, is_compact) + primes_bytes(y);
+  s2_easy += pi_approx(y) * 16;
+  formulas[3] = { "S2_easy", s2_easy };
+
+  // S2_hard.cpp
+  int64_t max_prime = min(y, z / isqrt(y));
+  int64_t max_b = (int64_t) pi_approx(isqrt(z));
+  double s2_hard = FactorTable_bytes(y);
+  s2_hard += primes_bytes(y);
+  s2_hard += PiTable_bytes(max_prime, is_compact);
+  s2_hard += threads * Sieve_bytes(z, max_b);
+  formulas[4] = { "S2_hard", s2_hard };
+}
+
+/// Truncate to 3 digits after the decimal point,
+/// same as the alpha tuning factors in util.cpp.
+///
+double truncate3(double n)
+{
+  return (int64_t)(n * 1000) / 1000.0;
+}
+
+std::string to_str_bytes(double bytes)
+{
+  const char* units[] = { "bytes", "KiB", "MiB", "GiB", "TiB", "PiB" };
+  int i = 0;
+
+  for (; bytes >= 1024 && i < 5; i++)
+    bytes /= 1024;
+
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision((i > 0) ? 2 : 0) << bytes << " " << units[i];
+  return oss.str();
+}
+
+void print_formulas(const Formula* formulas,
+                    int size,
+                    bool is_compact)
+{
+  for (int i = 0; i < size; i++)
+    std::cout << formulas[i].name << " = " << to_str_bytes(formulas[i].bytes) << std::endl;
+
+  std::cout << "Peak memory usage = " << to_str_bytes(peak(formulas, size)) << std::endl;
+
+  if (max_memory_ > 0)
+    std::cout << "Max memory = " << to_str_bytes(max_memory_) << std::endl;
+  if (is_compact)
+    std::cout << "Lookup tables = compact" << std::endl;
+}
+
+} // namespace
+
+namespace primecount {
+
+void set_max_memory(double bytes)
+{
+  if (bytes <= 0)
+    max_memory_ = -1;
+  else
+    max_memory_ = bytes;
+}
+
+/// Returns -1 if no memory limit has been set
+double get_max_memory()
+{
+  return max_memory_;
+}
+
+/// PiTable uses 16 bytes per 240 numbers, the compact
+/// PiTable uses 64 bytes per 1680 numbers (+ 1 block
+/// for aligning the blocks to 64 bytes).
+///
+double PiTable_bytes(int64_t n, bool is_compact)
+{
+  if (is_compact)
+    return (n / 1680 + 2) * 64.0;
+  else
+    return (n / 240 + 1) * 16.0;
+}
+
+/// Predicted peak memory usage in bytes
+/// of Xavier Gourdon's algorithm.
+///
+double memory_usage_gourdon(maxint_t x,
+                            int64_t y,
+                            int64_t z,
+                            int threads,
+                            bool is_compact)
+{
+  Formula formulas[5];
+  gourdon_formulas(x, y, z, threads, is_compact, formulas);
+  return peak(formulas, 5);
+}
+
+/// Predicted peak memory usage in bytes
+/// of the Deleglise-Rivat algorithm.
+///
+double memory_usage_deleglise_rivat(maxint_t x,
+                                    int64_t y,
+                                    int threads,
+                                    bool is_compact)
+{
+  Formula formulas[5];
+  deleglise_rivat_formulas(x, y, threads, is_compact, formulas);
+  return peak(formulas, 5);
+}
+
+/// Decrease alpha_z (and afterwards alpha_y) until the
+/// predicted peak memory usage of Xavier Gourdon's
+/// algorithm is <= max memory. The largest lookup tables,
+/// PiTable(z) in AC.cpp and FactorTableD(z) in D.cpp,
+/// shrink linearly with z = x^(1/3) * alpha_y * alpha_z.
+/// Before decreasing alpha (which slows down the
+/// computation much more) we switch to the compact
+/// PiTable layout and CompactFactorTableD.
+///
+void fit_max_memory_gourdon(maxint_t x,
+                            double& alpha_y,
+                            double& alpha_z)
+{
+  if (max_memory_ <= 0)
+    return;
+
+  int threads = get_num_threads();
+  bool is_compact = false;
+
+  while (true)
+  {
+    auto yz = get_yz_gourdon(x, alpha_y, alpha_z);
+    double bytes = memory_usage_gourdon(x, yz.first, yz.second, threads, is_compact);
+
+    if (bytes <= max_memory_)
+      return;
+    else if (!is_compact)
+      is_compact = true;
+    else if (alpha_z > 1)
+      alpha_z = max(1.0, truncate3(alpha_z * 0.9));
+    else if (alpha_y > 1)
+      alpha_y = max(1.0, truncate3(alpha_y * 0.9));
+    else
+      return;
+  }
+}
+
+/// Decrease alpha until the predicted peak memory
+/// usage of the Deleglise-Rivat algorithm is <= max
+/// memory. The largest lookup tables (FactorTable and
+/// PiTable) shrink linearly with y = x^(1/3) * alpha.
+/// Before decreasing alpha we switch to the compact
+/// PiTable layout.
+///
+void fit_max_memory_deleglise_rivat(maxint_t x, double& alpha)
+{
+  if (max_memory_ <= 0)
+    return;
+
+  int threads = get_num_threads();
+  int64_t x13 = iroot<3>(x);
+  bool is_compact = false;
+
+  while (true)
+  {
+    int64_t y = (int64_t)(x13 * alpha);
+    if (memory_usage_deleglise_rivat(x, y, threads, is_compact) <= max_memory_)
+      return;
+    else if (!is_compact)
+      is_compact = true;
+    else if (alpha > 1)
+      alpha = max(1.0, truncate3(alpha * 0.9));
+    else
+      return;
+  }
+}
+
+/// The PiTables of Xavier Gourdon's algorithm use the
+/// compact layout (and D(x, y) uses CompactFactorTableD
+/// for large z) if the predicted peak memory usage using
+/// the default lookup tables is > max memory. Computed
+/// once by pi_gourdon_64(x) & pi_gourdon_128(x) and
+/// passed to the formulas, nested pi(x) computations
+/// choose their own layout.
+///
+bool is_compact_pi_table_gourdon(maxint_t x,
+                                 int64_t y,
+                                 int64_t z,
+                                 int threads)
+{
+  return max_memory_ > 0 &&
+         memory_usage_gourdon(x, y, z, threads, false) > max_memory_;
+}
+
+/// Same as is_compact_pi_table_gourdon()
+/// but for the Deleglise-Rivat algorithm.
+///
+bool is_compact_pi_table_deleglise_rivat(maxint_t x,
+                                         int64_t y,
+                                         int threads)
+{
+  return max_memory_ > 0 &&
+         memory_usage_deleglise_rivat(x, y, threads, false) > max_memory_;
+}
+
+/// Reduce the number of threads until the predicted
+/// peak memory usage is <= max memory. Throws a
+/// primecount_error if even a single thread uses
+/// more memory than allowed.
+///
+int max_memory_threads_gourdon(maxint_t x,
+                               int64_t y,
+                               int64_t z,
+                               int threads,
+                               bool is_compact)
+{
+  if (max_memory_ <= 0)
+    return threads;
+
+  for (; threads > 1; threads--)
+    if (memory_usage_gourdon(x, y, z, threads, is_compact) <= max_memory_)
+      return threads;
+
+  double bytes = memory_usage_gourdon(x, y, z, 1, is_compact);
+
+  if (bytes > max_memory_)
+    throw primecount_error("max memory " + to_str_bytes(max_memory_) +
+                           " too small, pi(x) requires at least " +
+                           to_str_bytes(bytes));
+
+  return 1;
+}
+
+/// Reduce the number of threads until the predicted
+/// peak memory usage is <= max memory. Throws a
+/// primecount_error if even a single thread uses
+/// more memory than allowed.
+///
+int max_memory_threads_deleglise_rivat(maxint_t x,
+                                       int64_t y,
+                                       int threads,
+                                       bool is_compact)
+{
+  if (max_memory_ <= 0)
+    return threads;
+
+  for (; threads > 1; threads--)
+    if (memory_usage_deleglise_rivat(x, y, threads, is_compact) <= max_memory_)
+      return threads;
+
+  double bytes = memory_usage_deleglise_rivat(x, y, 1, is_compact);
+
+  if (bytes > max_memory_)
+    throw primecount_error("max memory " + to_str_bytes(max_memory_) +
+                           " too small, pi(x) requires at least " +
+                           to_str_bytes(bytes));
+
+  return 1;
+}
+
+/// Print the predicted memory usage of the formulas of
+/// Xavier Gourdon's algorithm for the default alpha_y
+/// and alpha_z tuning factors.
+///
+void print_memory_usage_gourdon(maxint_t x, int threads)
+{
+  auto alpha = get_alpha_gourdon(x);
+  auto yz = get_yz_gourdon(x, alpha.first, alpha.second);
+  int64_t y = yz.first;
+  int64_t z = yz.second;
+  int64_t k = PhiTiny::get_k(x);
+  bool is_compact = is_compact_pi_table_gourdon(x, y, z, threads);
+  threads = max_memory_threads_gourdon(x, y, z, threads, is_compact);
+
+  Formula formulas[5];
+  gourdon_formulas(x, y, z, threads, is_compact, formulas);
+
+  print("");
+  print("=== Memory usage estimate, pi_gourdon(x) ===");
+  print_gourdon(x, y, z, k, threads);
+  print_formulas(formulas, 5, is_compact);
+}
+
+/// Print the predicted memory usage of the formulas
+/// of the Deleglise-Rivat algorithm for the default
+/// alpha tuning factor.
+///
+void print_memory_usage_deleglise_rivat(maxint_t x, int threads)
+{
+  double alpha = get_alpha_deleglise_rivat(x);
+  int64_t y = (int64_t)(iroot<3>(x) * alpha);
+  y = max(y, 1);
+  int64_t z = (int64_t)(x / y);
+  int64_t c = PhiTiny::get_c(y);
+  bool is_compact = is_compact_pi_table_deleglise_rivat(x, y, threads);
+  threads = max_memory_threads_deleglise_rivat(x, y, threads, is_compact);
+
+  Formula formulas[5];
+  deleglise_rivat_formulas(x, y, threads, is_compact, formulas);
+
+  print("");
+  print("=== Memory usage estimate, pi_deleglise_rivat(x) ===");
+  print(x, y, z, c, threads);
+  print_formulas(formulas, 5, is_compact);
+}
+
+} // namespace
@@ -11,13 +11,21 @@
 #include <primecount.hpp>
 #include <primecount-internal.hpp>
 #include <primesieve.hpp>
+#include <sieve_window.hpp>
 #include <PiTable.hpp>
+#include <PrimesieveThreads.hpp>
 #include <Vector.hpp>
 #include <imath.hpp>
 #include <macros.hpp>
+#include <min.hpp>
+#include <popcnt.hpp>
+#include <int128_t.hpp>
 
 #include <stdint.h>
+#include <algorithm>
+#include <cmath>
 #include <string>
+#include <vector>
 
 using namespace primecount;
 
@@ -48,6 +56,22 @@ const Array<int16_t, 170> primes =
   941, 947, 953, 967, 971, 977, 983, 991, 997, 1009
 };
 
+/// When we are close to the nth prime we split the
+/// remaining search interval into this many chunks
+/// whose primes are counted using all threads.
+constexpr uint64_t parts = 8;
+
+/// Each call to primesieve::count_primes(low, high) needs to
+/// generate the sieving primes <= sqrt(high), hence it is
+/// only worth splitting the search interval into chunks
+/// if it is much larger than sqrt(high).
+///
+uint64_t max_serial_dist(uint64_t high)
+{
+  uint64_t min_dist = (uint64_t) 1e8;
+  return max(min_dist, isqrt(high));
+}
+
 /// Find the nth prime using binary search
 /// and a PrimePi(x) lookup table.
 /// Run time: O(log2(n))
@@ -74,6 +98,188 @@ int64_t binary_search_nth_prime(int64_t n)
   return low;
 }
 
+/// Find the nth prime >= low.
+/// Instead of iterating over the primes using a single thread
+/// we count the primes inside large chunks using primesieve's
+/// multi-threaded count_primes() until we find the chunk that
+/// contains the nth prime. Then we split that chunk into
+/// smaller chunks and repeat. Only the last small chunk is
+/// sieved using primesieve::iterator.
+///
+int64_t nth_prime_forward(uint64_t low,
+                          int64_t n,
+                          int64_t avg_prime_gap,
+                          int threads)
+{
+  ASSERT(n >= 1);
+  uint64_t dist = n * avg_prime_gap;
+  uint64_t min_dist = max_serial_dist(low + dist);
+  PrimesieveThreads primesieve_threads(threads);
+
+  while (dist > min_dist)
+  {
+    uint64_t chunk = ceil_div(dist, parts);
+
+    while (true)
+    {
+      uint64_t high = low + chunk - 1;
+      int64_t count = primesieve::count_primes(low, high);
+      if (count >= n)
+        break;
+      n -= count;
+      low = high + 1;
+    }
+
+    dist = chunk;
+  }
+
+  int64_t prime = -1;
+  primesieve::iterator iter(low, low + dist);
+  for (int64_t i = 0; i < n; i++)
+    prime = iter.next_prime();
+
+  return prime;
+}
+
+/// Find the nth prime <= high, counting backwards
+/// i.e. n = 1 returns the largest prime <= high.
+///
+int64_t nth_prime_backward(uint64_t high,
+                           int64_t n,
+                           int64_t avg_prime_gap,
+                           int threads)
+{
+  ASSERT(n >= 1);
+  uint64_t dist = n * avg_prime_gap;
+  uint64_t min_dist = max_serial_dist(high);
+  PrimesieveThreads primesieve_threads(threads);
+
+  while (dist > min_dist)
+  {
+    uint64_t chunk = ceil_div(dist, parts);
+
+    while (true)
+    {
+      uint64_t low = (high >= chunk) ? high - chunk + 1 : 0;
+      int64_t count = primesieve::count_primes(low, high);
+      if (count >= n)
+        break;
+      // high = low - 1 would underflow
+      if (low == 0)
+        break;
+      n -= count;
+      high = low - 1;
+    }
+
+    dist = chunk;
+  }
+
+  int64_t prime = -1;
+  uint64_t stop = (high >= dist) ? high - dist : 0;
+  primesieve::iterator iter(high, stop);
+  for (int64_t i = 0; i < n; i++)
+    prime = iter.prev_prime();
+
+  return prime;
+}
+
+
+#ifdef HAVE_INT128_T
+
+/// Find the nth prime >= low, with low > sqrt(nth prime).
+/// Used when the nth prime is > 2^63 and hence
+/// primesieve (which is limited to 2^64) cannot be used.
+///
+int128_t nth_prime_sieve_forward(uint128_t low,
+                                 int64_t n,
+                                 int64_t avg_prime_gap,
+                                 int threads)
+{
+  ASSERT(n >= 1);
+  low += (low % 2 == 0);
+  Vector<uint64_t> sieve;
+
+  int64_t min_size = 1 << 16;
+  int64_t max_size = 1 << 27;
+  int64_t size = in_between(min_size, n * avg_prime_gap / 2, max_size);
+
+  // Keeping the sieving primes pays off
+  // if at least 3 windows are sieved.
+  bool keep_primes = n * avg_prime_gap / 2 > 2 * max_size;
+  SieveWindow window(threads, keep_primes);
+
+  while (true)
+  {
+    window.sieve(low, size, sieve);
+
+    for (std::size_t i = 0; i < sieve.size(); i++)
+    {
+      uint64_t bits = ~sieve[i];
+      int64_t count = popcnt64(bits);
+
+      if (count < n)
+        n -= count;
+      else
+      {
+        for (; n > 1; n--)
+          bits &= bits - 1;
+        uint64_t j = i * 64 + popcnt64((bits & -bits) - 1);
+        return (int128_t) (low + 2 * j);
+      }
+    }
+
+    low += 2 * (uint128_t) size;
+  }
+}
+
+/// Find the nth prime <= high counting backwards,
+/// i.e. n = 1 returns the largest prime <= high.
+///
+int128_t nth_prime_sieve_backward(uint128_t high,
+                                  int64_t n,
+                                  int64_t avg_prime_gap,
+                                  int threads)
+{
+  ASSERT(n >= 1);
+  high -= (high % 2 == 0);
+  Vector<uint64_t> sieve;
+
+  int64_t min_size = 1 << 16;
+  int64_t max_size = 1 << 27;
+  int64_t size = in_between(min_size, n * avg_prime_gap / 2, max_size);
+
+  // Keeping the sieving primes pays off
+  // if at least 3 windows are sieved.
+  bool keep_primes = n * avg_prime_gap / 2 > 2 * max_size;
+  SieveWindow window(threads, keep_primes);
+
+  while (true)
+  {
+    uint128_t low = high - 2 * (uint128_t) (size - 1);
+    window.sieve(low, size, sieve);
+
+    for (std::size_t i = sieve.size(); i > 0; i--)
+    {
+      uint64_t bits = ~sieve[i - 1];
+      int64_t count = popcnt64(bits);
+
+      if (count < n)
+        n -= count;
+      else
+      {
+        for (; n > 1; n--)
+          bits ^= 1ull << ilog2(bits);
+        uint64_t j = (i - 1) * 64 + ilog2(bits);
+        return (int128_t) (low + 2 * j);
+      }
+    }
+
+    high = low - 2;
+  }
+}
+
+#endif
+
 } // namespace
 
 namespace primecount {
@@ -107,25 +313,127 @@ int64_t nth_prime(int64_t n, int threads)
   int64_t prime = -1;
 
   // Here we are very close to the nth prime < sqrt(nth_prime),
-  // we simply iterate over the primes until we find it.
+  // we count the primes in parallel until we find it.
+  if (count_approx < n)
+    prime = nth_prime_forward(prime_approx + 1, n - count_approx, avg_prime_gap, threads);
+  else // if (count_approx >= n)
+    prime = nth_prime_backward(prime_approx, count_approx - n + 1, avg_prime_gap, threads);
+
+  return prime;
+}
+
+/// Find the nth prime for many n using a shared pi(x) anchor.
+/// We process the n in ascending order, if the next n is
+/// close to the previous n we sieve forward from the previous
+/// nth prime. Otherwise computing pi(x) for a new anchor near
+/// the next nth prime is faster.
+///
+std::vector<int64_t> nth_prime_batch(const std::vector<int64_t>& n, int threads)
+{
+  for (int64_t nth : n)
+  {
+    if_unlikely(nth < 1)
+      throw primecount_error("nth_prime_batch(n): n must be >= 1");
+    if_unlikely(nth > max_n)
+      throw primecount_error("nth_prime_batch(n): n must be <= " + std::to_string(max_n));
+  }
+
+  std::vector<std::size_t> order(n.size());
+  for (std::size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+
+  std::sort(order.begin(), order.end(),
+    [&](std::size_t i, std::size_t j) { return n[i] < n[j]; });
+
+  std::vector<int64_t> res(n.size());
+  int64_t prime = 0;
+  int64_t count = 0;
+
+  // Here prime is the count-th prime
+  for (std::size_t i : order)
+  {
+    int64_t nth = n[i];
+
+    if (nth > count)
+    {
+      int64_t prime_approx = RiemannR_inverse(nth);
+      int64_t avg_prime_gap = ilog(prime_approx) + 2;
+      int64_t dist = (nth - count) * avg_prime_gap;
+
+      // Sieving from the previous nth prime is faster
+      // than computing pi(x) for a new anchor.
+      if (count > 0 && sieve_cost(prime, prime + dist) <= pi_cost(prime_approx))
+        prime = nth_prime_forward(prime + 1, nth - count, avg_prime_gap, threads);
+      else
+        prime = nth_prime(nth, threads);
+
+      count = nth;
+    }
+
+    res[i] = prime;
+  }
+
+  return res;
+}
+
+#ifdef HAVE_INT128_T
+
+/// 128-bit nth prime function.
+/// For n <= max_n we use the 64-bit nth_prime(n). For larger
+/// n the nth prime is > 2^63, we approximate it using the
+/// inverse Riemann R function and count the primes up to this
+/// approximation. The nth prime is then usually within
+/// O(sqrt(x) * log(x)) of the approximation. If sieving the
+/// remaining window is more expensive than another pi(x)
+/// computation (see sieve_cost.cpp) we refine the
+/// approximation and count the primes again, the remaining
+/// window is then sieved in parallel.
+///
+int128_t nth_prime(int128_t n, int threads)
+{
+  if (n <= max_n)
+    return nth_prime((int64_t) n, threads);
+
+  int128_t max_x = to_maxint(get_max_x());
+  int128_t prime_approx = RiemannR_inverse(n);
+
+  if_unlikely(prime_approx > max_x)
+    throw primecount_error("nth_prime(n): nth prime must be <= " + get_max_x());
+
+  int128_t count_approx = pi(prime_approx, threads);
+  double log_x = std::log((double) prime_approx);
+  int64_t avg_prime_gap = (int64_t) log_x + 2;
+
+  while (true)
+  {
+    int128_t diff = n - count_approx;
+    int128_t dist = (diff < 0 ? -diff : diff) * avg_prime_gap;
+    if (sieve_cost(prime_approx, prime_approx + dist) <= pi_cost(prime_approx))
+      break;
+
+    prime_approx += (int128_t) (diff * log_x);
+    count_approx = pi(prime_approx, threads);
+  }
+
   if (count_approx < n)
   {
-    uint64_t start = prime_approx + 1;
-    uint64_t stop = start + (n - count_approx) * avg_prime_gap;
-    primesieve::iterator iter(start, stop);
-    for (int64_t i = count_approx; i < n; i++)
-      prime = iter.next_prime();
+    int64_t count = (int64_t) (n - count_approx);
+    return nth_prime_sieve_forward(prime_approx + 1, count, avg_prime_gap, threads);
   }
   else // if (count_approx >= n)
   {
-    uint64_t start = prime_approx;
-    uint64_t stop = start - (count_approx - n) * avg_prime_gap;
-    primesieve::iterator iter(start, stop);
-    for (int64_t i = count_approx; i >= n; i--)
-      prime = iter.prev_prime();
+    int64_t count = (int64_t) (count_approx - n + 1);
+    return nth_prime_sieve_backward(prime_approx, count, avg_prime_gap, threads);
   }
+}
 
-  return prime;
+#endif
+
+std::string nth_prime(const std::string& n, int threads)
+{
+  maxint_t nth = to_maxint(n);
+  maxint_t res = nth_prime(nth, threads);
+  return to_string(res);
 }
 
 } // namespace
@@ -0,0 +1,248 @@
+///
+/// @file  pi_anchor.cpp
+/// @brief Table of known pi(x) values (anchors) which is used to
+///        speed up pi(x) computations for x close to an anchor.
+///        If x is close to an anchor we compute
+///        pi(x) = pi(anchor) +- count_primes(anchor, x)
+///        using the segmented sieve of Eratosthenes, which is
+///        much faster than computing pi(x) using Xavier Gourdon's
+///        algorithm if x is close enough to the anchor (see
+///        sieve_cost.cpp).
+///
+///        The anchors are pi(10^n) from OEIS A006880, pi(2^n)
+///        from OEIS A007053 and doc/Records.md and the
+///        (10^n)th prime numbers from doc/Records.md. In order to
+///        keep the table compact (and readable) both x and pi(x)
+///        are stored as 2 decimal parts: hi * 10^18 + lo.
+///        If the result cache is enabled (see result_cache.cpp)
+///        the previously computed pi(x) values are also used
+///        as anchors.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primecount-internal.hpp>
+#include <primesieve.hpp>
+#include <PrimesieveThreads.hpp>
+#include <sieve_window.hpp>
+#include <imath.hpp>
+#include <int128_t.hpp>
+#include <print.hpp>
+#include <result_cache.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace primecount;
+
+struct Anchor
+{
+  uint64_t x_hi;
+  uint64_t x_lo;
+  uint64_t pix_hi;
+  uint64_t pix_lo;
+};
+
+/// Sorted by x, x = x_hi * 10^18 + x_lo,
+/// pi(x) = pix_hi * 10^18 + pix_lo.
+///
+const Anchor anchors[] =
+{
+  {           0,                 10,          0,                  4 }, // 10^1
+  {           0,                100,          0,                 25 }, // 10^2
+  {           0,               1000,          0,                168 }, // 10^3
+  {           0,              10000,          0,               1229 }, // 10^4
+  {           0,             100000,          0,               9592 }, // 10^5
+  {           0,            1000000,          0,              78498 }, // 10^6
+  {           0,           10000000,          0,             664579 }, // 10^7
+  {           0,          100000000,          0,            5761455 }, // 10^8
+  {           0,         1000000000,          0,           50847534 }, // 10^9
+  {           0,         4294967296,          0,          203280221 }, // 2^32
+  {           0,        10000000000,          0,          455052511 }, // 10^10
+  {           0,       100000000000,          0,         4118054813 }, // 10^11
+  {           0,      1000000000000,          0,        37607912018 }, // 10^12
+  {           0,     10000000000000,          0,       346065536839 }, // 10^13
+  {           0,     29996224275833,          0,      1000000000000 }, // p(10^12)
+  {           0,    100000000000000,          0,      3204941750802 }, // 10^14
+  {           0,    323780508946331,          0,     10000000000000 }, // p(10^13)
+  {           0,   1000000000000000,          0,     29844570422669 }, // 10^15
+  {           0,  10000000000000000,          0,    279238341033925 }, // 10^16
+  {           0, 100000000000000000,          0,   2623557157654233 }, // 10^17
+  {           1,                  0,          0,  24739954287740860 }, // 10^18
+  {          10,                  0,          0, 234057667276344607 }, // 10^19
+  {          18, 446744073709551616,          0, 425656284035217743 }, // 2^64
+  {         100,                  0,          2, 220819602560918840 }, // 10^20
+  {        1000,                  0,         21, 127269486018731928 }, // 10^21
+  {       10000,                  0,        201, 467286689315906290 }, // 10^22
+  {      100000,                  0,       1925, 320391606803968923 }, // 10^23
+  {     1000000,                  0,      18435, 599767349200867866 }, // 10^24
+  {     5596564, 467986980643073683,     100000,                  0 }, // p(10^23)
+  {    10000000,                  0,     176846, 309399143769411680 }, // 10^25
+  {    58310039, 994836584070534263,    1000000,                  0 }, // p(10^24)
+  {   100000000,                  0,    1699246, 750872437141327603 }, // 10^26
+  {   154742504, 910672534362390528,    2610087, 356951889016077639 }, // 2^87
+  {   309485009, 821345068724781056,    5159830, 247726102115466054 }, // 2^88
+  {   606527267, 811189857426370533,   10000000,                  0 }, // p(10^25)
+  {   618970019, 642690137449562112,   10201730, 804263125133012340 }, // 2^89
+  {  1000000000,                  0,   16352460, 426841680446427399 }, // 10^27
+  {  1237940039, 285380274899124224,   20172933, 541156002700963336 }, // 2^90
+  {  2475880078, 570760549798248448,   39895115, 987049029184882256 }, // 2^91
+  {  4951760157, 141521099596496896,   78908656, 317357166866404346 }, // 2^92
+  { 10000000000,                  0,  157589269, 275973410412739598 }, // 10^28
+  {100000000000,                  0, 1520698109, 714272166094258063 }  // 10^29
+};
+
+/// Returns true if x <= 2^64 - 1
+template <typename T>
+bool is_uint64(T x)
+{
+  return sizeof(T) <= sizeof(uint64_t) ||
+         x <= (T) pstd::numeric_limits<uint64_t>::max();
+}
+
+template <typename T>
+T to_int(uint64_t hi, uint64_t lo)
+{
+  return (T) hi * (T) 1000000000000000000ull + (T) lo;
+}
+
+/// Returns true if the anchor fits into T
+template <typename T>
+bool is_representable(const Anchor& a)
+{
+  // 9 * 10^18 < 2^63 - 1
+  return a.x_hi < 9 || sizeof(T) > sizeof(int64_t);
+}
+
+/// Count the primes inside [low, high]
+template <typename T>
+T count_primes(T low, T high, int threads)
+{
+  if (is_uint64(high))
+  {
+    // pi_anchor(x) may be called from inside of
+    // a parallel region e.g. in B(x, y).
+    PrimesieveThreads primesieve_threads(threads);
+    return (T) primesieve::count_primes((uint64_t) low, (uint64_t) high);
+  }
+
+#if defined(HAVE_INT128_T)
+  // All anchors > 2^64 are much larger than
+  // 2^64 + 2^63, hence low > sqrt(high).
+  return (T) count_primes_window(low, high, threads);
+#else
+  return -1;
+#endif
+}
+
+template <typename T>
+T pi_anchor_OpenMP(T x, int threads, bool is_print)
+{
+  bool found = false;
+  double best_cost = 0;
+  T ax = 0;
+  T pix = 0;
+
+  auto update = [&](T anchor, T pi_anchor)
+  {
+    T low = std::min(x, anchor) + 1;
+    T high = std::max(x, anchor);
+    double cost = sieve_cost(low, high);
+
+    if (!found || cost < best_cost)
+    {
+      found = true;
+      best_cost = cost;
+      ax = anchor;
+      pix = pi_anchor;
+    }
+  };
+
+  for (const Anchor& a : anchors)
+  {
+    if (!is_representable<T>(a))
+      break;
+
+    update(to_int<T>(a.x_hi, a.x_lo),
+           to_int<T>(a.pix_hi, a.pix_lo));
+  }
+
+  // Previously computed pi(x) values (if
+  // the result cache is enabled).
+  maxint_t cached_x;
+  maxint_t cached_pix;
+  if (result_cache_nearest_pi(x, cached_x, cached_pix) &&
+      cached_x <= pstd::numeric_limits<T>::max())
+    update((T) cached_x, (T) cached_pix);
+
+  if (!found || best_cost > pi_cost(x))
+    return -1;
+
+  double time = get_time();
+
+  if (is_print)
+  {
+    print("");
+    print("=== pi_anchor(x) ===");
+    print("x", x);
+    print("anchor", ax);
+    print("pi(anchor)", pix);
+    print("threads", threads);
+  }
+
+  if (x > ax)
+    pix += count_primes(ax + 1, x, threads);
+  else if (x < ax)
+    pix -= count_primes(x + 1, ax, threads);
+
+  if (is_print)
+    print("pi(x)", pix, time);
+
+  return pix;
+}
+
+} // namespace
+
+namespace primecount {
+
+int64_t pi_anchor(int64_t x, int threads, bool is_print)
+{
+  return pi_anchor_OpenMP(x, threads, is_print);
+}
+
+#ifdef HAVE_INT128_T
+
+int128_t pi_anchor(int128_t x, int threads, bool is_print)
+{
+  return pi_anchor_OpenMP(x, threads, is_print);
+}
+
+#endif
+
+/// Returns all anchors that fit into maxint_t,
+/// as (x, pi(x)) pairs sorted by x.
+///
+std::vector<std::pair<maxint_t, maxint_t>> get_pi_anchors()
+{
+  std::vector<std::pair<maxint_t, maxint_t>> res;
+
+  for (const Anchor& a : anchors)
+  {
+    if (!is_representable<maxint_t>(a))
+      break;
+
+    res.emplace_back(to_int<maxint_t>(a.x_hi, a.x_lo),
+                     to_int<maxint_t>(a.pix_hi, a.pix_lo));
+  }
+
+  return res;
+}
+
+} // namespace
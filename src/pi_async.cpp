@@ -0,0 +1,210 @@
+///
+/// @file  pi_async.cpp
+/// @brief Asynchronous pi(x) and nth_prime(n) computations with
+///        cooperative cancellation and progress callbacks. The
+///        computation runs in a background std::thread which
+///        creates its own OpenMP thread team. See AsyncContext.hpp
+///        for how cancellation is implemented.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primecount.hpp>
+#include <primecount-internal.hpp>
+#include <AsyncContext.hpp>
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace {
+
+thread_local primecount::AsyncContext* async_context_ = nullptr;
+
+} // namespace
+
+namespace primecount {
+
+AsyncContext* get_async_context()
+{
+  return async_context_;
+}
+
+void set_async_context(AsyncContext* context)
+{
+  async_context_ = context;
+}
+
+void check_cancelled()
+{
+  if (async_context_ &&
+      async_context_->is_cancelled())
+    throw primecount_error("computation cancelled");
+}
+
+/// Report the progress at most 10 times per second
+void AsyncContext::progress(double percent)
+{
+  percent_.store(percent, std::memory_order_relaxed);
+
+  if (callback_)
+  {
+    double time = get_time();
+
+    if (time - time_ >= 0.1)
+    {
+      time_ = time;
+      callback_(percent);
+    }
+  }
+}
+
+struct AsyncResult::State
+{
+  AsyncContext context;
+  std::thread thread;
+  std::mutex mutex;
+  std::string result;
+  std::string error;
+  bool finished = false;
+};
+
+AsyncResult::AsyncResult()
+  : state_(new State)
+{ }
+
+AsyncResult::AsyncResult(AsyncResult&&) noexcept = default;
+
+/// The computation of this handle is cancelled (and joined)
+/// before taking over the computation of the other handle,
+/// destroying a joinable std::thread would call
+/// std::terminate().
+///
+AsyncResult& AsyncResult::operator=(AsyncResult&& other) noexcept
+{
+  if (this != &other)
+  {
+    if (state_ && state_->thread.joinable())
+    {
+      state_->context.cancel();
+      state_->thread.join();
+    }
+
+    state_ = std::move(other.state_);
+  }
+
+  return *this;
+}
+
+AsyncResult::~AsyncResult()
+{
+  if (state_ && state_->thread.joinable())
+  {
+    state_->context.cancel();
+    state_->thread.join();
+  }
+}
+
+AsyncResult AsyncResult::start(const std::function<std::string(int)>& compute,
+                               const AsyncOptions& options)
+{
+  int threads = options.threads;
+  if (threads <= 0)
+    threads = get_num_threads();
+
+  AsyncResult handle;
+  State* state = handle.state_.get();
+  state->context.set_callback(options.progress);
+
+  state->thread = std::thread([state, compute, threads]()
+  {
+    set_async_context(&state->context);
+    std::string result;
+    std::string error;
+
+    try {
+      result = compute(threads);
+    }
+    catch (std::exception& e) {
+      error = e.what();
+    }
+
+    // When cancelled the load balancers stop handing out
+    // work, hence the result is incomplete.
+    if (state->context.is_cancelled())
+      error = "computation cancelled";
+
+    set_async_context(nullptr);
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->result = result;
+    state->error = error;
+    state->finished = true;
+  });
+
+  return handle;
+}
+
+std::string AsyncResult::wait()
+{
+  if (!state_)
+    throw primecount_error("AsyncResult: invalid handle");
+
+  if (state_->thread.joinable())
+    state_->thread.join();
+
+  if (!state_->error.empty())
+    throw primecount_error(state_->error);
+
+  return state_->result;
+}
+
+bool AsyncResult::poll() const
+{
+  if (!state_)
+    return true;
+
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->finished;
+}
+
+void AsyncResult::cancel()
+{
+  if (state_)
+    state_->context.cancel();
+}
+
+double AsyncResult::percent() const
+{
+  if (!state_)
+    return 0;
+
+  return state_->context.percent();
+}
+
+AsyncResult pi_async(const std::string& x,
+                     const AsyncOptions& options)
+{
+  // Check x before starting the thread
+  maxint_t n = to_maxint(x);
+
+  return AsyncResult::start([n](int threads) {
+    return to_string(pi(n, threads)); }, options);
+}
+
+AsyncResult nth_prime_async(const std::string& n,
+                            const AsyncOptions& options)
+{
+  to_maxint(n);
+
+  return AsyncResult::start([n](int threads) {
+    return nth_prime(n, threads); }, options);
+}
+
+} // namespace
@@ -0,0 +1,99 @@
+///
+/// @file  pi_interval.cpp
+/// @brief Count the primes inside the interval [low, high].
+///        If the interval is small we count the primes using the
+///        segmented sieve of Eratosthenes, else we compute
+///        pi(high) - pi(low - 1) using Xavier Gourdon's algorithm.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primecount.hpp>
+#include <primecount-internal.hpp>
+#include <primesieve.hpp>
+#include <PrimesieveThreads.hpp>
+#include <sieve_window.hpp>
+#include <imath.hpp>
+#include <int128_t.hpp>
+#include <min.hpp>
+
+#include <stdint.h>
+#include <string>
+
+namespace {
+
+using namespace primecount;
+
+/// Counting the primes inside [low, high] using the segmented
+/// sieve of Eratosthenes is faster than computing
+/// pi(high) - pi(low - 1) if sieving [low, high] is cheaper
+/// than two pi(x) computations (see sieve_cost.cpp).
+///
+bool is_sieve_faster(maxint_t low, maxint_t high)
+{
+  return sieve_cost(low, high) <= 2 * pi_cost(high);
+}
+
+} // namespace
+
+namespace primecount {
+
+int64_t pi(int64_t low, int64_t high, int threads)
+{
+  low = max(low, 2);
+
+  if (low > high)
+    return 0;
+
+  if (is_sieve_faster(low, high))
+  {
+    PrimesieveThreads primesieve_threads(threads);
+    return primesieve::count_primes(low, high);
+  }
+  else
+    return pi(high, threads) - pi(low - 1, threads);
+}
+
+#ifdef HAVE_INT128_T
+
+int128_t pi(int128_t low, int128_t high, int threads)
+{
+  low = max(low, 2);
+
+  if (low > high)
+    return 0;
+
+  // Use 64-bit if possible
+  if (high <= pstd::numeric_limits<int64_t>::max())
+    return pi((int64_t) low, (int64_t) high, threads);
+
+  if (is_sieve_faster(low, high))
+  {
+    if (high <= pstd::numeric_limits<uint64_t>::max())
+    {
+      PrimesieveThreads primesieve_threads(threads);
+      return primesieve::count_primes((uint64_t) low, (uint64_t) high);
+    }
+    if (low > isqrt(high))
+      return count_primes_window(low, high, threads);
+  }
+
+  return pi(high, threads) - pi(low - 1, threads);
+}
+
+#endif
+
+std::string pi(const std::string& low,
+               const std::string& high,
+               int threads)
+{
+  maxint_t l = to_maxint(low);
+  maxint_t h = to_maxint(high);
+  maxint_t res = pi(l, h, threads);
+  return to_string(res);
+}
+
+} // namespace
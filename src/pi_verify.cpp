@@ -0,0 +1,204 @@
+///
+/// @file  pi_verify.cpp
+/// @brief Compute pi(x) using both Xavier Gourdon's algorithm and
+///        the Deleglise-Rivat algorithm in a single process in
+///        order to verify the result (--verify option).
+///
+///        Gourdon: pi(x) = A - B + C + D + Phi0 + Sigma
+///        Deleglise-Rivat: pi(x) = S1 + S2 + pi(y) - 1 - P2
+///
+///        Both algorithms are run using the same y, hence the
+///        P2(x, y) formula of the Deleglise-Rivat algorithm can be
+///        computed from Gourdon's B(x, y) formula in O(1) and the
+///        B(x, y) formula is only computed once (using all
+///        threads). Afterwards the remaining formulas of both
+///        algorithms, which are independent from each other, are
+///        computed concurrently: the Deleglise-Rivat formulas run
+///        in a background std::thread with its own OpenMP thread
+///        team and the threads are split evenly between both
+///        algorithms. When using a single thread both algorithms
+///        are computed one after the other.
+///
+///        If the results differ, all independent formulas are
+///        recomputed using a different number of threads and the
+///        formulas whose results are not reproducible (e.g. due
+///        to a hardware error) are reported.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primecount.hpp>
+#include <primecount-internal.hpp>
+#include <imath.hpp>
+#include <int128_t.hpp>
+#include <macros.hpp>
+#include <PhiTiny.hpp>
+#include <pi_verify.hpp>
+#include <print.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+using namespace primecount;
+
+namespace {
+
+template <typename T>
+T pi_verify_OpenMP(T x,
+                   int threads,
+                   bool is_print,
+                   const char* name)
+{
+  auto alpha = get_alpha_gourdon(x);
+  double alpha_y = alpha.first;
+  double alpha_z = alpha.second;
+  maxint_t limit = get_max_x(alpha_y);
+
+  if_unlikely(x > limit)
+    throw primecount_error("pi(x): x must be <= " + to_string(limit));
+
+  int64_t x13 = iroot<3>(x);
+  int64_t sqrtx = isqrt(x);
+  auto yz = get_yz_gourdon(x, alpha_y, alpha_z);
+  int64_t y = yz.first;
+  int64_t z = yz.second;
+  int64_t k = PhiTiny::get_k(x);
+
+  // The Deleglise-Rivat algorithm requires y >= x^(1/3),
+  // this is not the case for Gourdon's y if x is tiny.
+  if (y < x13)
+  {
+    T pix_gourdon = pi_gourdon(x, threads);
+    T pix_dr = pi_deleglise_rivat(x, threads);
+
+    if (pix_gourdon != pix_dr)
+    {
+      std::ostringstream oss;
+      oss << "pi(x) verification failed for x = " << x
+          << "\npi_gourdon(x) = " << pix_gourdon
+          << "\npi_deleglise_rivat(x) = " << pix_dr;
+      throw primecount_error(oss.str());
+    }
+
+    return pix_gourdon;
+  }
+
+  // Use the compact PiTable layout and reduce the
+  // number of threads if the predicted memory
+  // usage exceeds the user's --max-memory.
+  bool is_compact = is_compact_pi_table_gourdon(x, y, z, threads);
+  threads = max_memory_threads_gourdon(x, y, z, threads, is_compact);
+  int threads_gourdon = std::max(1, threads / 2);
+  int threads_dr = threads - threads_gourdon;
+
+  double time;
+
+  if (is_print)
+  {
+    print("");
+    print(name);
+    print("Gourdon: pi(x) = A - B + C + D + Phi0 + Sigma");
+    print("Deleglise-Rivat: pi(x) = S1 + S2 + pi(y) - 1 - P2");
+    print_gourdon(x, y, z, k, threads);
+  }
+
+  int64_t pi_y = pi_noprint(y, threads);
+  T b = B(x, y, threads, is_print);
+  T p2 = 0;
+
+  // P2(x, y) = B(x, y) - \sum_{i=pi[y]+1}^{pi[sqrt(x)]} (i - 1)
+  if (y < sqrtx)
+  {
+    T a = pi_y;
+    T pi_sqrtx = pi_noprint(sqrtx, threads);
+    p2 = b + (a - 2) * (a + 1) / 2 - (pi_sqrtx - 2) * (pi_sqrtx + 1) / 2;
+  }
+
+  if (is_print)
+  {
+    print("");
+    print("=== Gourdon & Deleglise-Rivat ===");
+    print("P2", p2);
+    print("threads (Gourdon)", threads_gourdon);
+    print("threads (Deleglise-Rivat)", std::max(threads_dr, 1));
+    time = get_time();
+  }
+
+  GourdonFormulas<T> g;
+  DelegliseRivatFormulas<T> dr;
+  compute_formulas(x, y, z, k, pi_y, b, p2, threads_gourdon, threads_dr, is_compact, g, dr);
+
+  T pix_gourdon = g.ac - b + g.d + g.phi0 + g.sigma;
+  T s2 = dr.s2_trivial + dr.s2_easy + dr.s2_hard;
+  T pix_dr = dr.s1 + s2 + pi_y - 1 - p2;
+
+  if (is_print)
+  {
+    print("Sigma", g.sigma);
+    print("Phi0", g.phi0);
+    print("A + C", g.ac);
+    print("D", g.d);
+    print("S1", dr.s1);
+    print("S2_trivial", dr.s2_trivial);
+    print("S2_easy", dr.s2_easy);
+    print("S2_hard", dr.s2_hard);
+    print("pi_gourdon", pix_gourdon);
+    print("pi_deleglise_rivat", pix_dr, time);
+  }
+
+  if (pix_gourdon != pix_dr)
+  {
+    std::ostringstream oss;
+    oss << "pi(x) verification failed for x = " << x
+        << "\npi_gourdon(x) = " << pix_gourdon
+        << "\npi_deleglise_rivat(x) = " << pix_dr
+        << find_bad_formulas(x, y, z, k, pi_y, b, p2, threads_gourdon, threads_dr, is_compact, g, dr);
+
+    throw primecount_error(oss.str());
+  }
+
+  return pix_gourdon;
+}
+
+} // namespace
+
+namespace primecount {
+
+/// Compute pi(x) using both Xavier Gourdon's algorithm and the
+/// Deleglise-Rivat algorithm. Throws a primecount_error if the
+/// results differ.
+///
+int64_t pi_verify_64(int64_t x,
+                     int threads,
+                     bool is_print)
+{
+  if (x < 2)
+    return 0;
+
+  return pi_verify_OpenMP(x, threads, is_print, "=== pi_verify_64(x) ===");
+}
+
+#if defined(HAVE_INT128_T)
+
+/// Compute pi(x) using both Xavier Gourdon's algorithm and the
+/// Deleglise-Rivat algorithm. Throws a primecount_error if the
+/// results differ.
+///
+int128_t pi_verify_128(int128_t x,
+                       int threads,
+                       bool is_print)
+{
+  if (x < 2)
+    return 0;
+
+  return pi_verify_OpenMP(x, threads, is_print, "=== pi_verify_128(x) ===");
+}
+
+#endif
+
+} // namespace
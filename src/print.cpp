@@ -10,6 +10,7 @@
 #include <print.hpp>
 #include <primecount-internal.hpp>
 #include <int128_t.hpp>
+#include <Numa.hpp>
 #include <stdint.h>
 
 #include <iostream>
@@ -28,6 +29,9 @@ bool is_print_variables()
 void print_threads(int threads)
 {
   std::cout << "threads = " << threads << std::endl;
+
+  if (primecount::is_numa())
+    std::cout << "numa = " << primecount::numa_policy_str() << std::endl;
 }
 
 } // naespace
@@ -0,0 +1,357 @@
+///
+/// @file  result_cache.cpp
+/// @brief Opt-in memoization of the results of pi(x), nth_prime(n)
+///        and phi(x, a). Computing pi(x) for large x takes minutes
+///        or even hours, hence it makes sense to cache the results
+///        of services that compute the same values repeatedly.
+///
+///        The results are stored in memory using a least recently
+///        used (LRU) eviction policy. Optionally the results are
+///        also appended to a file (one "function x a result
+///        checksum" line per result) which is loaded again by the
+///        next process. Lines whose checksum does not match (e.g.
+///        corrupted or partially written lines) are ignored.
+///        If a cached pi(x) value is close to x, pi_anchor.cpp
+///        computes pi(x) by sieving the distance to the cached x.
+///
+///        The result cache is disabled by default, it can be
+///        enabled using set_result_cache_size(),
+///        set_result_cache_file() or using the environment
+///        variables PRIMECOUNT_RESULT_CACHE_SIZE and
+///        PRIMECOUNT_RESULT_CACHE_FILE.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <result_cache.hpp>
+#include <primecount.hpp>
+#include <primecount-internal.hpp>
+#include <int128_t.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace {
+
+using namespace primecount;
+
+const char* function_names[] = { "pi", "nth_prime", "phi" };
+
+struct Key
+{
+  int function;
+  maxint_t x;
+  int64_t a;
+
+  bool operator<(const Key& other) const
+  {
+    if (function != other.function)
+      return function < other.function;
+    if (x != other.x)
+      return x < other.x;
+    return a < other.a;
+  }
+};
+
+class ResultCache
+{
+public:
+  ResultCache()
+  {
+    const char* size = std::getenv("PRIMECOUNT_RESULT_CACHE_SIZE");
+    const char* file = std::getenv("PRIMECOUNT_RESULT_CACHE_FILE");
+
+    if (size && *size)
+      set_size(std::atoll(size));
+
+    // An exception thrown here would be rethrown by
+    // each call to result_cache(), instead we only
+    // disable the result cache file.
+    if (file && *file)
+    {
+      try {
+        set_file(file);
+      }
+      catch (std::exception& e) {
+        std::cerr << "PRIMECOUNT_RESULT_CACHE_FILE: " << e.what() << std::endl;
+      }
+    }
+  }
+
+  bool enabled() const
+  {
+    return enabled_;
+  }
+
+  void set_size(int64_t size)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_ = std::max(size, (int64_t) 0);
+    evict();
+    enabled_ = size_ > 0;
+  }
+
+  void set_file(const std::string& path)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (file_.is_open())
+      file_.close();
+    if (path.empty())
+      return;
+
+    if (size_ == 0)
+      size_ = default_size;
+
+    load(path);
+    file_.open(path, std::ios::app);
+
+    if (!file_)
+      throw primecount_error("failed to open result cache file: " + path);
+
+    enabled_ = true;
+  }
+
+  bool find(const Key& key, maxint_t& res)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = map_.find(key);
+
+    if (iter == map_.end())
+      return false;
+
+    // Move to the front (most recently used)
+    lru_.splice(lru_.begin(), lru_, iter->second);
+    res = iter->second->second;
+    return true;
+  }
+
+  void insert(const Key& key, maxint_t res)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    insert_memory(key, res);
+
+    if (file_.is_open())
+    {
+      std::string line = function_names[key.function];
+      line += ' ' + to_string(key.x);
+      line += ' ' + std::to_string(key.a);
+      line += ' ' + to_string(res);
+      file_ << line << ' '
+            << std::hex << std::setw(16) << std::setfill('0')
+            << result_cache_checksum(line)
+            << std::dec << std::endl;
+    }
+  }
+
+  /// Find the cached pi(x) value whose x is closest to x
+  bool nearest_pi(maxint_t x, maxint_t& cached_x, maxint_t& cached_pix)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto next = map_.lower_bound(Key{CACHE_PI, x, 0});
+    bool found = false;
+
+    if (next != map_.end() &&
+        next->first.function == CACHE_PI)
+    {
+      cached_x = next->first.x;
+      cached_pix = next->second->second;
+      found = true;
+    }
+
+    if (next != map_.begin())
+    {
+      auto prev = std::prev(next);
+      if (prev->first.function == CACHE_PI &&
+          (!found || x - prev->first.x < cached_x - x))
+      {
+        cached_x = prev->first.x;
+        cached_pix = prev->second->second;
+        found = true;
+      }
+    }
+
+    return found;
+  }
+
+private:
+  using List = std::list<std::pair<Key, maxint_t>>;
+  static constexpr int64_t default_size = 1 << 16;
+
+  /// Load the results of previous processes. Invalid lines
+  /// (e.g. a partially written last line, a checksum that
+  /// does not match or an impossible result) are ignored.
+  ///
+  void load(const std::string& path)
+  {
+    std::ifstream in(path);
+    std::string line;
+
+    while (std::getline(in, line))
+    {
+      std::size_t pos = line.find_last_of(' ');
+      if (pos == std::string::npos)
+        continue;
+
+      std::string checksum = line.substr(pos + 1);
+      line.resize(pos);
+
+      if (checksum.size() != 16 ||
+          checksum.find_first_not_of("0123456789abcdef") != std::string::npos ||
+          std::stoull(checksum, nullptr, 16) != result_cache_checksum(line))
+        continue;
+
+      std::istringstream iss(line);
+      std::string name, x, a, res, extra;
+
+      if (!(iss >> name >> x >> a >> res) || (iss >> extra))
+        continue;
+
+      for (int f = CACHE_PI; f <= CACHE_PHI; f++)
+      {
+        if (name == function_names[f])
+        {
+          try {
+            Key key{f, to_maxint(x), (int64_t) to_maxint(a)};
+            maxint_t result = to_maxint(res);
+            if (is_valid(key, result))
+              insert_memory(key, result);
+          }
+          catch (std::exception&) { }
+        }
+      }
+    }
+  }
+
+  /// pi(x) <= x, phi(x, a) <= x and nth_prime(n) > n
+  static bool is_valid(const Key& key, maxint_t res)
+  {
+    if (key.x < 0 || key.a < 0 || res < 0)
+      return false;
+
+    switch (key.function)
+    {
+      case CACHE_PI:        return res <= key.x;
+      case CACHE_NTH_PRIME: return res > key.x;
+      default:              return res <= key.x;
+    }
+  }
+
+  void insert_memory(const Key& key, maxint_t res)
+  {
+    auto iter = map_.find(key);
+
+    if (iter != map_.end())
+    {
+      iter->second->second = res;
+      lru_.splice(lru_.begin(), lru_, iter->second);
+      return;
+    }
+
+    lru_.emplace_front(key, res);
+    map_[key] = lru_.begin();
+    evict();
+  }
+
+  /// Remove the least recently used results
+  void evict()
+  {
+    while ((int64_t) lru_.size() > size_)
+    {
+      map_.erase(lru_.back().first);
+      lru_.pop_back();
+    }
+  }
+
+  std::mutex mutex_;
+  std::atomic<bool> enabled_{false};
+  int64_t size_ = 0;
+  List lru_;
+  std::map<Key, List::iterator> map_;
+  std::ofstream file_;
+};
+
+ResultCache& result_cache()
+{
+  static ResultCache cache;
+  return cache;
+}
+
+} // namespace
+
+namespace primecount {
+
+/// 64-bit FNV-1a hash of a result cache file line
+/// (without the checksum), detects corrupted lines.
+///
+uint64_t result_cache_checksum(const std::string& line)
+{
+  uint64_t hash = 14695981039346656037ull;
+
+  for (unsigned char c : line)
+  {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+
+  return hash;
+}
+
+void set_result_cache_size(int64_t size)
+{
+  result_cache().set_size(size);
+}
+
+void set_result_cache_file(const std::string& path)
+{
+  result_cache().set_file(path);
+}
+
+bool is_result_cache()
+{
+  return result_cache().enabled();
+}
+
+bool result_cache_find(CachedFunction function,
+                       maxint_t x,
+                       int64_t a,
+                       maxint_t& res)
+{
+  return result_cache().find(Key{function, x, a}, res);
+}
+
+void result_cache_insert(CachedFunction function,
+                         maxint_t x,
+                         int64_t a,
+                         maxint_t res)
+{
+  result_cache().insert(Key{function, x, a}, res);
+}
+
+bool result_cache_nearest_pi(maxint_t x,
+                             maxint_t& cached_x,
+                             maxint_t& cached_pix)
+{
+  if (!is_result_cache())
+    return false;
+
+  return result_cache().nearest_pi(x, cached_x, cached_pix);
+}
+
+} // namespace
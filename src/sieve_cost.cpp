@@ -0,0 +1,101 @@
+///
+/// @file  sieve_cost.cpp
+/// @brief Cost model used to decide whether counting the primes
+///        inside [low, high] using the segmented sieve of
+///        Eratosthenes is faster than computing pi(x) using
+///        the prime counting function. Used by pi(low, high),
+///        nth_prime(n) and pi_anchor(x).
+///
+///        Both costs are measured in number of sieved numbers.
+///        pi_cost(x) has been fitted to these measurements on a
+///        single CPU core (benchmark/pi_cost.cpp, i.e.
+///        pi_gourdon_64(x) and primesieve::count_primes() near x):
+///
+///        x       pi(x)      sieving near x    pi(x) = sieving
+///        10^9      0.00 s   4.15 * 10^9 / s   3.78 * 10^6
+///        10^10     0.00 s   3.83 * 10^9 / s   1.10 * 10^7
+///        10^11     0.01 s   3.60 * 10^9 / s   3.37 * 10^7
+///        10^12     0.03 s   3.08 * 10^9 / s   9.03 * 10^7
+///        10^13     0.13 s   2.88 * 10^9 / s   3.59 * 10^8
+///        10^14     0.41 s   1.88 * 10^9 / s   7.70 * 10^8
+///        10^15     2.04 s   1.51 * 10^9 / s   3.07 * 10^9
+///        10^16     7.80 s   1.51 * 10^9 / s   1.18 * 10^10
+///        10^17    28.47 s   8.04 * 10^8 / s   2.29 * 10^10
+///        10^18   120.02 s   5.33 * 10^8 / s   6.39 * 10^10
+///        10^19   553.65 s   1.97 * 10^8 / s   1.09 * 10^11
+///
+///        10^19 has been measured using the primecount binary
+///        (primecount 1e19 --gourdon -t1) as 10^19 > 2^63.
+///        Above 10^19 primesieve cannot be used anymore and
+///        there are no measurements.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primecount-internal.hpp>
+#include <int128_t.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace primecount {
+
+/// pi(x) uses O(x^(2/3) / log(x)^2) time, but the sieving
+/// throughput also decreases as x grows because the sieving
+/// primes no longer fit into the CPU's caches. Combined, the
+/// measured cost of pi(x) is 64 * sqrt(x) to 118 * sqrt(x)
+/// sieved numbers for 10^10 <= x <= 10^18. This fit is only
+/// valid inside the measured range 10^10 <= x <= 10^19,
+/// outside of it the model is clamped:
+///
+/// x < 10^10: 10^7, the cost of pi(10^10).
+/// 10^18 < x <= 10^19: 9 * 10^10, the cost of pi(10^18). The
+/// slower sieving near 10^19 offsets the slower pi(10^19).
+/// x > 10^19: the cost of pi(10^19) scaled by the run time
+/// complexity of pi(x), the sieving throughput of
+/// count_primes_window() is accounted for in sieve_cost().
+///
+double pi_cost(maxint_t x)
+{
+  double dx = (double) x;
+  double max_fit = 1e18;
+  double max_measured = 1e19;
+
+  if (dx <= max_measured)
+  {
+    double sqrtx = std::sqrt(std::min(dx, max_fit));
+    return std::max(1e7, 90 * sqrtx);
+  }
+
+  auto complexity = [](double n) {
+    return std::pow(n, 2.0 / 3.0) / std::pow(std::log(n), 2);
+  };
+
+  double cost = 90 * std::sqrt(max_fit);
+  return cost * complexity(dx) / complexity(max_measured);
+}
+
+/// Estimated cost of counting the primes inside [low, high]
+/// using the segmented sieve of Eratosthenes. primesieve
+/// generates the sieving primes only once, whereas
+/// count_primes_window() (for high > 2^64) iterates over
+/// all sieving primes <= sqrt(high) for each segment of
+/// 2^28 numbers.
+///
+double sieve_cost(maxint_t low, maxint_t high)
+{
+  double dist = (double) std::max(high - low, (maxint_t) 0);
+  double sqrt_high = std::sqrt((double) high);
+
+  if (sizeof(maxint_t) <= sizeof(uint64_t) ||
+      high <= (maxint_t) pstd::numeric_limits<uint64_t>::max())
+    return dist + sqrt_high;
+
+  double segments = std::ceil(dist / (1 << 28));
+  return dist + segments * sqrt_high;
+}
+
+} // namespace
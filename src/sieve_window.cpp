@@ -0,0 +1,358 @@
+///
+/// @file  sieve_window.cpp
+/// @brief Segmented sieve of Eratosthenes for small windows
+///        [low, high] with high > 2^64 (i.e. with 128-bit
+///        sieving offsets). This is used by nth_prime(n) and
+///        pi(low, high) for 128-bit numbers since primesieve
+///        is limited to 2^64.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <sieve_window.hpp>
+#include <primecount-internal.hpp>
+#include <primesieve.hpp>
+#include <imath.hpp>
+#include <int128_t.hpp>
+#include <macros.hpp>
+#include <min.hpp>
+#include <popcnt.hpp>
+#include <Vector.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+#ifdef HAVE_INT128_T
+
+using namespace primecount;
+
+/// Returns the sieve index j of the first odd multiple
+/// of prime >= low (i.e. low + 2 * j). Since low is odd,
+/// low + k is odd if k is even. Note that j < prime.
+///
+uint64_t first_multiple(uint128_t low, uint64_t prime)
+{
+  uint64_t r = (uint64_t)(low % prime);
+  uint64_t k = (r == 0) ? 0 : prime - r;
+  if (k & 1)
+    k += prime;
+  return k / 2;
+}
+
+#endif
+
+} // namespace
+
+namespace primecount {
+
+#ifdef HAVE_INT128_T
+
+SieveWindow::SieveWindow(int threads, bool keep_primes) :
+  keep_primes_(keep_primes),
+  threads_(threads)
+{
+  int64_t chunks = threads * 4;
+  primes_.resize(chunks);
+  buckets_.resize(chunks);
+}
+
+/// Sieve the odd numbers inside [low, low + 2 * size[ using
+/// 128-bit sieving offsets, bit i of the sieve array corresponds
+/// to the number low + 2 * i. Composite numbers are marked with a
+/// 1 bit. The sieving primes that are not kept are processed in
+/// batches: first the threads compute the first multiple of each
+/// sieving prime (128-bit modulo) for their own chunks of
+/// sieving primes, hence this also scales well when sqrt(high)
+/// is much larger than the window. Afterwards each thread crosses
+/// off the multiples inside its own range of sieve words, hence
+/// no atomic operations are needed.
+///
+void SieveWindow::sieve(uint128_t low,
+                        int64_t size,
+                        Vector<uint64_t>& sieve)
+{
+  ASSERT(low % 2 == 1);
+  ASSERT(size > 0);
+
+  uint128_t high = low + 2 * (size - 1);
+  uint64_t sqrt_high = (uint64_t) isqrt(high);
+  int64_t words = ceil_div(size, 64);
+  ASSERT(low > sqrt_high);
+
+  sieve.resize(words);
+  std::fill_n(sieve.begin(), words, 0);
+
+  // Unused bits of the last word are marked as composite
+  if (size % 64)
+    sieve[words - 1] = ~0ull << (size % 64);
+
+  // Each thread sieves a range of at least 2^10 sieve words
+  int64_t min_words = 1 << 10;
+  int64_t ranges = in_between(1, threads_, ceil_div(words, min_words));
+  uint64_t range_size = ceil_div(words, ranges) * 64;
+
+  for (int64_t i = 0; i < (int64_t) primes_.size(); i++)
+  {
+    primes_[i].clear();
+    buckets_[i].resize(ranges);
+    for (auto& bucket : buckets_[i])
+      bucket.clear();
+  }
+
+  // Sieving primes < size may have many multiples inside the
+  // window, each thread crosses off their multiples inside its
+  // range. Larger sieving primes have at most one multiple
+  // inside the window, it is added to the bucket of its range.
+  // The kept sieving primes are sorted, those < size are
+  // processed directly from the kept_ array.
+  if (keep_primes_)
+  {
+    uint64_t max_kept = pstd::numeric_limits<uint32_t>::max();
+    update_primes(low, size, range_size);
+    add_primes(low, size, range_size, min(sqrt_high, max_kept));
+    ASSERT(low > kept_stop_);
+
+    std::size_t small_primes = std::lower_bound(kept_.begin(), kept_.end(), (uint64_t) size,
+        [](const KeptPrime& kp, uint64_t n) { return kp.prime < n; }) - kept_.begin();
+
+    cross_off(sieve, size, ranges, range_size, small_primes);
+  }
+
+  // The sieving primes that are not kept
+  int64_t chunks = primes_.size();
+  uint64_t chunk = 1 << 22;
+  uint64_t batch = chunk * chunks;
+
+  for (uint64_t batch_low = kept_stop_ + 1; batch_low <= sqrt_high; batch_low += batch)
+  {
+    #pragma omp parallel for schedule(dynamic) num_threads(threads_)
+    for (int64_t i = 0; i < chunks; i++)
+    {
+      primes_[i].clear();
+      for (auto& bucket : buckets_[i])
+        bucket.clear();
+
+      uint64_t start = batch_low + chunk * i;
+      uint64_t stop = min(start + chunk - 1, sqrt_high);
+      if (start > stop)
+        continue;
+
+      primesieve::iterator it(start, stop);
+
+      for (uint64_t prime = it.next_prime(); prime <= stop; prime = it.next_prime())
+      {
+        uint64_t j = first_multiple(low, prime);
+
+        if (prime < (uint64_t) size)
+          primes_[i].push_back(SievingPrime{prime, j});
+        else if (j < (uint64_t) size)
+          buckets_[i][j / range_size].push_back(j);
+      }
+    }
+
+    cross_off(sieve, size, ranges, range_size, 0);
+  }
+}
+
+/// Update the sieve indexes of the kept sieving primes for the
+/// new window and add their multiples inside the window to the
+/// buckets. For a window that starts d odd numbers after the
+/// previous window the next multiple of prime is at index
+/// (j - d) mod prime, this only requires a 64-bit modulo if
+/// d > prime. Windows may also move backwards.
+///
+void SieveWindow::update_primes(uint128_t low,
+                                uint64_t size,
+                                uint64_t range_size)
+{
+  uint128_t dist = (low > low_) ? low - low_ : low_ - low;
+  bool forward = (low > low_);
+  low_ = low;
+
+  if (dist / 2 > pstd::numeric_limits<uint64_t>::max())
+  {
+    kept_.clear();
+    kept_stop_ = 2;
+  }
+
+  uint64_t d = (uint64_t) (dist / 2);
+  int64_t chunks = buckets_.size();
+  uint64_t chunk_primes = ceil_div(kept_.size(), chunks);
+
+  #pragma omp parallel for num_threads(threads_)
+  for (int64_t i = 0; i < chunks; i++)
+  {
+    uint64_t start = chunk_primes * i;
+    uint64_t stop = min(start + chunk_primes, kept_.size());
+
+    for (uint64_t k = start; k < stop; k++)
+    {
+      uint64_t prime = kept_[k].prime;
+      uint64_t j = kept_[k].j;
+      uint64_t dp = (d < prime) ? d : d % prime;
+
+      if (forward)
+        j = (j >= dp) ? j - dp : j + prime - dp;
+      else
+      {
+        j += dp;
+        if (j >= prime)
+          j -= prime;
+      }
+
+      kept_[k].j = (uint32_t) j;
+
+      if (prime >= size && j < size)
+        buckets_[i][j / range_size].push_back(j);
+    }
+  }
+}
+
+/// Add the sieving primes inside ]kept_stop_, stop] to the
+/// kept sieving primes. Their first multiples are computed
+/// in parallel in pieces of 2^26 numbers.
+///
+void SieveWindow::add_primes(uint128_t low,
+                             uint64_t size,
+                             uint64_t range_size,
+                             uint64_t stop)
+{
+  if (kept_stop_ >= stop)
+    return;
+
+  // pi(x) < 1.25506 * x / log(x), Rosser & Schoenfeld
+  kept_.reserve(kept_.size() + (std::size_t) (1.25506 * stop / std::log((double) stop)));
+  int64_t chunks = buckets_.size();
+  uint64_t piece = 1 << 26;
+  Vector<uint32_t> new_primes;
+
+  for (uint64_t start = kept_stop_ + 1; start <= stop; start += piece)
+  {
+    uint64_t piece_stop = min(start + piece - 1, stop);
+    primesieve::iterator it(start, piece_stop);
+    new_primes.clear();
+
+    for (uint64_t prime = it.next_prime(); prime <= piece_stop; prime = it.next_prime())
+      new_primes.push_back((uint32_t) prime);
+
+    uint64_t old_size = kept_.size();
+    uint64_t chunk_primes = ceil_div(new_primes.size(), chunks);
+    kept_.resize(old_size + new_primes.size());
+
+    #pragma omp parallel for num_threads(threads_)
+    for (int64_t i = 0; i < chunks; i++)
+    {
+      uint64_t first = chunk_primes * i;
+      uint64_t last = min(first + chunk_primes, new_primes.size());
+
+      for (uint64_t k = first; k < last; k++)
+      {
+        uint64_t prime = new_primes[k];
+        uint64_t j = first_multiple(low, prime);
+        kept_[old_size + k] = KeptPrime{(uint32_t) prime, (uint32_t) j};
+
+        if (prime >= size && j < size)
+          buckets_[i][j / range_size].push_back(j);
+      }
+    }
+  }
+
+  kept_stop_ = stop;
+}
+
+/// Each thread crosses off the multiples of the sieving primes
+/// inside its own range of sieve words: the kept sieving
+/// primes < size, the sieving primes of the current batch
+/// and the multiples inside the buckets of its range.
+///
+void SieveWindow::cross_off(Vector<uint64_t>& sieve,
+                            uint64_t size,
+                            int64_t ranges,
+                            uint64_t range_size,
+                            std::size_t small_primes)
+{
+  int64_t chunks = primes_.size();
+
+  #pragma omp parallel for num_threads(ranges)
+  for (int64_t r = 0; r < ranges; r++)
+  {
+    uint64_t range_low = range_size * r;
+    uint64_t range_high = min(range_low + range_size, size);
+
+    for (std::size_t k = 0; k < small_primes; k++)
+    {
+      uint64_t prime = kept_[k].prime;
+      uint64_t j = kept_[k].j;
+
+      if (j < range_low)
+        j += ceil_div(range_low - j, prime) * prime;
+      for (; j < range_high; j += prime)
+        sieve[j / 64] |= 1ull << (j % 64);
+    }
+
+    for (int64_t i = 0; i < chunks; i++)
+    {
+      for (const SievingPrime& sp : primes_[i])
+      {
+        uint64_t prime = sp.prime;
+        uint64_t j = sp.j;
+
+        if (j < range_low)
+          j += ceil_div(range_low - j, prime) * prime;
+        for (; j < range_high; j += prime)
+          sieve[j / 64] |= 1ull << (j % 64);
+      }
+
+      for (uint64_t j : buckets_[i][r])
+        sieve[j / 64] |= 1ull << (j % 64);
+    }
+  }
+}
+
+/// Count the primes inside [low, high].
+/// The window is processed in segments of 2^28 numbers.
+///
+int128_t count_primes_window(uint128_t low,
+                             uint128_t high,
+                             int threads)
+{
+  int128_t count = 0;
+  low += (low % 2 == 0);
+  high -= (high % 2 == 0);
+
+  if (low > high)
+    return count;
+
+  int64_t max_size = 1 << 27;
+  uint128_t odd_numbers = (high - low) / 2 + 1;
+  // Keeping the sieving primes pays off
+  // if at least 3 windows are sieved.
+  Vector<uint64_t> sieve;
+  bool keep_primes = odd_numbers > 2 * (uint128_t) max_size;
+  SieveWindow window(threads, keep_primes);
+
+  while (odd_numbers > 0)
+  {
+    int64_t size = (int64_t) min(odd_numbers, max_size);
+    window.sieve(low, size, sieve);
+
+    for (uint64_t bits : sieve)
+      count += popcnt64(~bits);
+
+    odd_numbers -= size;
+    low += 2 * (uint128_t) size;
+  }
+
+  return count;
+}
+
+#endif
+
+} // namespace
@@ -16,8 +16,10 @@
 #include <imath.hpp>
 #include <macros.hpp>
 #include <min.hpp>
+#include <Vector.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <string>
@@ -28,6 +30,13 @@ namespace {
 
 int status_precision_ = -1;
 
+// LoadBalancerS2 assigns contiguous work intervals
+// to threads (when possible) so that they can
+// carry forward their phi[] and sieve.
+bool is_contiguous_work_ = true;
+
+std::atomic<uint64_t> vector_allocations_(0);
+
 // Tuning factor used in the Lagarias-Miller-Odlyzko
 // and Deleglise-Rivat algorithms.
 double alpha_ = -1;
@@ -145,6 +154,26 @@ void set_status_precision(int precision)
   status_precision_ = in_between(0, precision, 5);
 }
 
+void set_contiguous_work(bool is_contiguous)
+{
+  is_contiguous_work_ = is_contiguous;
+}
+
+bool is_contiguous_work()
+{
+  return is_contiguous_work_;
+}
+
+void count_vector_allocation() noexcept
+{
+  vector_allocations_.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t get_vector_allocations() noexcept
+{
+  return vector_allocations_.load(std::memory_order_relaxed);
+}
+
 /// Get the time in seconds (with microsecond accuracy).
 /// Note that according to the documentation of
 /// std::chrono::steady_clock: "This clock is not related to wall
@@ -307,8 +336,13 @@ double get_alpha_deleglise_rivat(maxint_t x)
   // Preserve 3 digits after decimal point
   alpha = in_between(1, alpha, x16);
   alpha = truncate3(alpha);
+  alpha = in_between(1, alpha, x16);
 
-  return in_between(1, alpha, x16);
+  // Decrease alpha if the predicted memory
+  // usage exceeds the user's --max-memory.
+  fit_max_memory_deleglise_rivat(x, alpha);
+
+  return alpha;
 }
 
 /// In Xavier Gourdon's algorithm there are 2 alpha tuning
@@ -395,9 +429,41 @@ std::pair<double, double> get_alpha_gourdon(maxint_t x)
   double max_alpha_z = max(1.0, x16 / alpha_y);
   alpha_z = in_between(1, alpha_z, max_alpha_z);
 
+  // Decrease alpha_y & alpha_z if the predicted
+  // memory usage exceeds the user's --max-memory.
+  fit_max_memory_gourdon(x, alpha_y, alpha_z);
+
   return std::make_pair(alpha_y, alpha_z);
 }
 
+/// y = x^(1/3) * alpha_y and z = y * alpha_z of Xavier
+/// Gourdon's algorithm, with x^(1/3) < y <= z < x^(1/2).
+/// Used by pi_gourdon_64(x), pi_gourdon_128(x) and
+/// all other functions that need the same y & z.
+///
+std::pair<int64_t, int64_t> get_yz_gourdon(maxint_t x,
+                                           double alpha_y,
+                                           double alpha_z)
+{
+  int64_t x13 = iroot<3>(x);
+  int64_t sqrtx = isqrt(x);
+  int64_t y = (int64_t)(x13 * alpha_y);
+
+  // x^(1/3) < y < x^(1/2)
+  y = std::max(y, x13 + 1);
+  y = std::min(y, sqrtx - 1);
+  y = std::max(y, (int64_t) 1);
+
+  int64_t z = (int64_t)(y * alpha_z);
+
+  // y <= z < x^(1/2)
+  z = std::max(z, y);
+  z = std::min(z, sqrtx - 1);
+  z = std::max(z, (int64_t) 1);
+
+  return std::make_pair(y, z);
+}
+
 /// x_star = max(x^(1/4), x / y^2)
 ///
 /// After my implementation of Xavier Gourdon's algorithm worked for
@@ -0,0 +1,91 @@
+///
+/// @file   Numa.cpp
+/// @brief  Test that the NUMA policies (interleaving and
+///         replicating the lookup tables, pinning the threads)
+///         do not change the results.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <Numa.hpp>
+#include <PiTable.hpp>
+#include <primecount.hpp>
+#include <primecount-internal.hpp>
+#include <gourdon.hpp>
+
+#include <stdint.h>
+#include <iostream>
+#include <cstdlib>
+#include <string>
+
+using namespace primecount;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  int threads = get_num_threads();
+
+  std::cout << "NUMA nodes = " << numa_nodes();
+  check(numa_nodes() >= 1);
+
+  std::cout << "NUMA current node = " << numa_current_node();
+  check(numa_current_node() >= 0 && numa_current_node() < numa_nodes());
+
+  // Invalid policy
+  try
+  {
+    set_numa_policy("invalid");
+    std::cout << "set_numa_policy(\"invalid\")";
+    check(false);
+  }
+  catch (primecount_error& e)
+  {
+    std::cout << "set_numa_policy(\"invalid\"): " << e.what();
+    check(get_numa_policy() == NUMA_DEFAULT);
+  }
+
+  // Known correct results, see test/gourdon/D.cpp
+  int64_t x = 100000000000LL;
+  int64_t y = 13825;
+  int64_t z = 13825;
+  int64_t k = 8;
+  int64_t D_x = 3738964518LL;
+  int64_t pix = 4118054813LL;
+
+  for (std::string policy : { "default", "interleave", "replicate" })
+  {
+    set_numa_policy(policy);
+    set_numa_pin(policy == "replicate");
+
+    std::cout << "numa = " << numa_policy_str();
+    check(is_numa() == (policy != "default"));
+
+    NumaReplicas<PiTable> piTables(100000, threads);
+    const PiTable& pi = piTables.local();
+    std::cout << "pi(99991) = " << pi[99991];
+    check(pi[99991] == 9592);
+
+    std::cout << "D(" << x << ", " << y << ") = " << D(x, y, z, k, Li(x), threads, false);
+    check(D(x, y, z, k, Li(x), threads, false) == D_x);
+
+    std::cout << "pi_gourdon_64(" << x << ") = " << pi_gourdon_64(x, threads, false);
+    check(pi_gourdon_64(x, threads, false) == pix);
+  }
+
+  set_numa_policy(NUMA_DEFAULT);
+  set_numa_pin(false);
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
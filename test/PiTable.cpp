@@ -188,6 +188,41 @@ int main()
     }
   }
 
+  // Test compact PiTable layout
+  {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<int> dist(0, 100000);
+
+    for (int i = 0; i < 100; i++)
+    {
+      uint64_t max_x = dist(gen);
+      PiTable pi1(max_x, 1, false);
+      PiTable pi2(max_x, 1, true);
+      bool OK = pi2.is_compact();
+
+      for (uint64_t x = 0; x <= max_x; x++)
+        OK &= (pi1[x] == pi2[x]);
+
+      std::cout << "Compact PiTable(" << max_x << ")";
+      check(OK);
+    }
+
+    // Multiple threads initialize the compact
+    // PiTable, test the thread boundaries.
+    int threads = 4;
+    uint64_t max_x = 45000000 + dist(gen);
+    PiTable pi1(max_x, threads, false);
+    PiTable pi2(max_x, threads, true);
+    bool OK = !pi1.is_compact() && pi2.is_compact();
+
+    for (uint64_t x = 0; x <= max_x; x++)
+      OK &= (pi1[x] == pi2[x]);
+
+    std::cout << "Compact PiTable(" << max_x << ", threads = " << threads << ")";
+    check(OK);
+  }
+
   std::cout << std::endl;
   std::cout << "All tests passed successfully!" << std::endl;
 
@@ -73,6 +73,11 @@ int main()
   std::cout << "nth_prime(" << n << ") = " << res;
   check(res == 9999999967);
 
+  in = "455052511";
+  out = nth_prime(in);
+  std::cout << "nth_prime(" << in << ") = " << out;
+  check(out == "9999999967");
+
   n = (int64_t) 1e12;
   int64_t a = 78498;
   res = phi(n, a);
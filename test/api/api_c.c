@@ -69,11 +69,28 @@ int main(void)
   printf("primecount_pi(%"PRId64") = %"PRId64, n, res);
   check(res == 455052511);
 
+  res = primecount_pi_interval(1000000000000, 1001000000000);
+  printf("primecount_pi_interval(1000000000000, 1001000000000) = %"PRId64, res);
+  check(res == 36190991);
+
+  primecount_pi_interval_str("1000000000000", "1001000000000", out, sizeof(out));
+  printf("primecount_pi_interval_str(1000000000000, 1001000000000) = %s", out);
+  check(strcmp(out, "36190991") == 0);
+
   n = 455052511;
   res = primecount_nth_prime(n);
   printf("primecount_nth_prime(%"PRId64") = %"PRId64, n, res);
   check(res == 9999999967);
 
+  primecount_nth_prime_str("455052511", out, sizeof(out));
+  printf("primecount_nth_prime_str(455052511) = %s", out);
+  check(strcmp(out, "9999999967") == 0);
+
+  // nth_prime(0) is an error and should hence return -1
+  int len = primecount_nth_prime_str("0", out, sizeof(out));
+  printf("primecount_nth_prime_str(0) = %d", len);
+  check(len == -1);
+
   // nth_prime(-1) is an error and should hence return -1
   // which indicates an error in the libprimecount C API.
   n = -1;
@@ -97,6 +114,18 @@ int main(void)
   printf("primecount_pi_str(%s) = %s", in, out);
   check(strcmp(out, "37607912018") == 0);
 
+  primecount_set_result_cache_size(10);
+  n = (int64_t) 1e11;
+  res = primecount_pi(n);
+  res = primecount_pi(n);
+  printf("primecount_pi(%"PRId64") with result cache = %"PRId64, n, res);
+  check(res == 4118054813);
+  primecount_set_result_cache_size(0);
+
+  int err = primecount_set_result_cache_file(NULL);
+  printf("primecount_set_result_cache_file(NULL) = %d", err);
+  check(err == -1);
+
   printf("\n");
   printf("All tests passed successfully!\n");
 
@@ -16,11 +16,13 @@
 #include <primecount.hpp>
 #include <primesieve.hpp>
 #include <PiTable.hpp>
+#include <int128_t.hpp>
 
 #include <stdint.h>
 #include <iostream>
 #include <cstdlib>
 #include <random>
+#include <string>
 
 using namespace primecount;
 
@@ -90,6 +92,20 @@ int main()
   n = 10000000000000ll;
   check_equal(n, nth_prime(n), 323780508946331ll);
 
+  // n > pi(2^63 - 1) uses the 128-bit nth_prime(n) which
+  // sieves the numbers > 2^64 using sieve_window().
+  // pi(2^64) = 425656284035217743 and 2^64 + 13 is the
+  // smallest prime > 2^64.
+#ifdef HAVE_INT128_T
+  {
+    std::string res = nth_prime("425656284035217744");
+    bool OK = (res == "18446744073709551629");
+    std::cout << "nth_prime(425656284035217744) = " << res << "   " << (OK ? "OK" : "ERROR") << "\n";
+    if (!OK)
+      std::exit(1);
+  }
+#endif
+
   std::cout << std::endl;
   std::cout << "All tests passed successfully!" << std::endl;
 
@@ -0,0 +1,95 @@
+///
+/// @file   nth_prime_batch.cpp
+/// @brief  Test the nth_prime_batch(n) function which computes
+///         the nth prime for many n using a shared pi(x) anchor.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primecount.hpp>
+
+#include <stdint.h>
+#include <iostream>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace primecount;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  std::random_device rd;
+  std::mt19937 gen(rd());
+
+  {
+    // Clustered and unsorted n including duplicates
+    std::uniform_int_distribution<int64_t> dist(-100000, 100000);
+    int64_t center = 100000000;
+    std::vector<int64_t> n;
+
+    for (int i = 0; i < 50; i++)
+      n.push_back(center + dist(gen));
+
+    n.push_back(n[0]);
+    n.push_back(1);
+    n.push_back(3315);
+
+    auto res = nth_prime_batch(n);
+    check(res.size() == n.size());
+
+    for (std::size_t i = 0; i < n.size(); i++)
+    {
+      std::cout << "nth_prime_batch(" << n[i] << ") = " << res[i];
+      check(res[i] == nth_prime(n[i]));
+    }
+  }
+
+  {
+    // Far apart n, each requires a new pi(x) anchor
+    std::vector<int64_t> n = { 10000000000ll, 10000000, 1000000000ll, 100000000 };
+    std::vector<int64_t> primes = { 252097800623ll, 179424673, 22801763489ll, 2038074743 };
+    auto res = nth_prime_batch(n);
+
+    for (std::size_t i = 0; i < n.size(); i++)
+    {
+      std::cout << "nth_prime_batch(" << n[i] << ") = " << res[i];
+      check(res[i] == primes[i]);
+    }
+  }
+
+  {
+    // nth_prime_batch({0}) must throw an exception
+    try
+    {
+      nth_prime_batch({ 10, 0 });
+      std::cout << "nth_prime_batch({ 10, 0 })";
+      check(false);
+    }
+    catch (primecount_error& e)
+    {
+      std::cout << "nth_prime_batch({ 10, 0 }): " << e.what();
+      check(true);
+    }
+  }
+
+  {
+    auto res = nth_prime_batch({});
+    std::cout << "nth_prime_batch({}).size() = " << res.size();
+    check(res.empty());
+  }
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+///
+/// @file   pi_async.cpp
+/// @brief  Test pi_async() and nth_prime_async(), progress
+///         callbacks and cancellation.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primecount.hpp>
+
+#include <stdint.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace primecount;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  {
+    AsyncResult res = pi_async("1000000000000");
+    std::string pix = res.wait();
+    std::cout << "pi_async(1e12) = " << pix;
+    check(pix == "37607912018");
+    std::cout << "poll() = " << res.poll();
+    check(res.poll());
+  }
+
+  {
+    AsyncResult res = nth_prime_async("12345678901");
+    std::string prime = res.wait();
+    std::cout << "nth_prime_async(12345678901) = " << prime;
+    check(prime == "313945524671");
+  }
+
+  {
+    int calls = 0;
+    double max_percent = 0;
+    AsyncOptions options;
+    options.progress = [&](double percent) {
+      calls++;
+      max_percent = std::max(max_percent, percent);
+    };
+
+    AsyncResult res = pi_async("23456789012", options);
+    std::string pix = res.wait();
+    std::cout << "pi_async(23456789012) = " << pix;
+    check(pix == "1027446369");
+    std::cout << "progress callback calls = " << calls;
+    check(calls >= 0 && max_percent <= 100);
+  }
+
+  {
+    AsyncResult res = pi_async("300000000000000000");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::cout << "poll() = " << res.poll();
+    check(!res.poll());
+    res.cancel();
+
+    auto start = std::chrono::steady_clock::now();
+    bool cancelled = false;
+
+    try {
+      res.wait();
+    }
+    catch (primecount_error& e) {
+      cancelled = true;
+      std::cout << "wait() after cancel(): " << e.what();
+    }
+
+    check(cancelled);
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "cancellation time = " << seconds << " sec";
+    check(seconds < 60);
+  }
+
+  {
+    // Move assignment cancels the running computation
+    AsyncResult res = pi_async("300000000000000000");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    res = pi_async("1000000000000");
+    std::string pix = res.wait();
+    std::cout << "move assigned pi_async(1e12) = " << pix;
+    check(pix == "37607912018");
+  }
+
+  {
+    // The destructor cancels a running computation
+    AsyncResult res = pi_async("300000000000000000");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+
+  {
+    bool error = false;
+
+    try {
+      pi_async("abc");
+    }
+    catch (std::exception&) {
+      error = true;
+    }
+
+    std::cout << "pi_async(\"abc\") throws";
+    check(error);
+  }
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
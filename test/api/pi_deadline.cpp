@@ -0,0 +1,77 @@
+///
+/// @file   pi_deadline.cpp
+/// @brief  Test pi_deadline(x, seconds), if the computation
+///         cannot finish in time RiemannR(x) is returned.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primecount.hpp>
+
+#include <stdint.h>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace primecount;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  {
+    DeadlineResult res = pi_deadline("100000000000", 0);
+    std::cout << "pi_deadline(1e11, 0) = " << res.pix;
+    check(res.is_exact && res.pix == "4118054813");
+  }
+
+  {
+    DeadlineResult res = pi_deadline("12345678901234", 1000);
+    std::cout << "pi_deadline(12345678901234, 1000) = " << res.pix;
+    check(res.is_exact && res.pix == pi("12345678901234"));
+  }
+
+  {
+    // pi(10^22) takes hours on a single CPU core,
+    // the computation must not even be started.
+    DeadlineResult res = pi_deadline("10000000000000000000000", 0.5);
+    std::cout << "pi_deadline(1e22, 0.5) = " << res.pix;
+    check(!res.is_exact);
+
+    double pix = std::stod(res.pix);
+    double exact = 201467286689315906290.0;
+    std::cout << "RiemannR(1e22) ~ pi(1e22)";
+    check(std::abs(pix - exact) / exact < 1e-9);
+
+    std::cout << "Predicted seconds = " << res.seconds;
+    check(res.seconds > 0.5);
+  }
+
+  {
+    bool error = false;
+
+    try {
+      pi_deadline("1e32", 1);
+    }
+    catch (std::exception&) {
+      error = true;
+    }
+
+    std::cout << "pi_deadline(1e32, 1) throws";
+    check(error);
+  }
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
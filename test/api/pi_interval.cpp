@@ -0,0 +1,126 @@
+///
+/// @file   pi_interval.cpp
+/// @brief  Test the pi(low, high) function which counts the
+///         primes inside the interval [low, high].
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primecount.hpp>
+#include <primesieve.hpp>
+#include <int128_t.hpp>
+
+#include <stdint.h>
+#include <iostream>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+using namespace primecount;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  std::random_device rd;
+  std::mt19937 gen(rd());
+
+  {
+    // Empty intervals
+    std::cout << "pi(100, 10) = " << pi(100, 10);
+    check(pi(100, 10) == 0);
+    std::cout << "pi(-10, 1) = " << pi(-10, 1);
+    check(pi(-10, 1) == 0);
+    std::cout << "pi(2, 2) = " << pi(2, 2);
+    check(pi(2, 2) == 1);
+  }
+
+  {
+    // Small intervals, uses the sieve of Eratosthenes
+    std::uniform_int_distribution<int64_t> dist_low(0, (int64_t) 1e12);
+    std::uniform_int_distribution<int64_t> dist(0, (int64_t) 1e6);
+
+    for (int i = 0; i < 50; i++)
+    {
+      int64_t low = dist_low(gen);
+      int64_t high = low + dist(gen);
+      int64_t res = pi(low, high);
+      std::cout << "pi(" << low << ", " << high << ") = " << res;
+      check(res == (int64_t) primesieve::count_primes(low, high));
+    }
+  }
+
+  {
+    // Large intervals, uses pi(high) - pi(low - 1)
+    std::uniform_int_distribution<int64_t> dist_low(0, (int64_t) 1e10);
+    std::uniform_int_distribution<int64_t> dist((int64_t) 1e8, (int64_t) 5e8);
+
+    for (int i = 0; i < 10; i++)
+    {
+      int64_t low = dist_low(gen);
+      int64_t high = low + dist(gen);
+      int64_t res = pi(low, high);
+      std::cout << "pi(" << low << ", " << high << ") = " << res;
+      check(res == (int64_t) primesieve::count_primes(low, high));
+    }
+  }
+
+  {
+    std::string low = "1000000000000";
+    std::string high = "1001000000000";
+    std::string res = pi(low, high);
+    std::cout << "pi(" << low << ", " << high << ") = " << res;
+    check(res == "36190991");
+  }
+
+#ifdef HAVE_INT128_T
+  {
+    // high + 1 must not overflow
+    std::string low = "9223372036854775808";
+    std::string high = "9223372036854775807";
+    std::string res = pi(low, high);
+    std::cout << "pi(2^63, 2^63 - 1) = " << res;
+    check(res == "0");
+
+    // 2^63 - 25 is the largest prime < 2^63
+    low = "9223372036854775777";
+    res = pi(low, high);
+    std::cout << "pi(2^63 - 31, 2^63 - 1) = " << res;
+    check(res == "1");
+  }
+
+  {
+    // 2^64 - 59 and 2^64 + 13 are the primes
+    // nearest to 2^64.
+    std::string low = "18446744073709551557";
+    std::string high = "18446744073709551629";
+    std::string res = pi(low, high);
+    std::cout << "pi(" << low << ", " << high << ") = " << res;
+    check(res == "2");
+
+    low = "18446744073709551558";
+    high = "18446744073709551628";
+    res = pi(low, high);
+    std::cout << "pi(" << low << ", " << high << ") = " << res;
+    check(res == "0");
+
+    low = "18446744073709551616";
+    res = pi(low, "18446744073709551629");
+    std::cout << "pi(" << low << ", 18446744073709551629) = " << res;
+    check(res == "1");
+  }
+#endif
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
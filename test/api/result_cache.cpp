@@ -0,0 +1,154 @@
+///
+/// @file   result_cache.cpp
+/// @brief  Test the result cache (set_result_cache_size() and
+///         set_result_cache_file()).
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primecount.hpp>
+#include <result_cache.hpp>
+#include <primecount-internal.hpp>
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace primecount;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  std::string path = "primecount_result_cache_test.txt";
+  std::remove(path.c_str());
+
+  // Result cache disabled
+  int64_t pix = pi((int64_t) 1e11);
+  std::cout << "pi(1e11) = " << pix;
+  check(pix == 4118054813ll);
+
+  set_result_cache_size(100);
+
+  {
+    // Cache miss + cache hit
+    int64_t x = 12345678901ll;
+    int64_t res1 = pi(x);
+    int64_t res2 = pi(x);
+    std::cout << "pi(" << x << ") = " << res2;
+    check(res1 == res2 && res1 == 556442057ll);
+
+    // Near miss: sieve the distance to x
+    int64_t res3 = pi(x + 1000000);
+    std::cout << "pi(" << x + 1000000 << ") = " << res3;
+    check(res3 == 556484954ll);
+  }
+
+  {
+    int64_t n = 12345678901ll;
+    int64_t res1 = nth_prime(n);
+    int64_t res2 = nth_prime(n);
+    std::cout << "nth_prime(" << n << ") = " << res2;
+    check(res1 == res2 && res1 == 313945524671ll);
+
+    std::string res3 = nth_prime(std::to_string(n));
+    std::cout << "nth_prime(\"" << n << "\") = " << res3;
+    check(res3 == std::to_string(res1));
+  }
+
+  {
+    int64_t x = 98765432109ll;
+    int64_t res1 = phi(x, 100);
+    int64_t res2 = phi(x, 100);
+    std::cout << "phi(" << x << ", 100) = " << res2;
+    check(res1 == res2 && res1 == phi(x, 100) && res1 != phi(x, 99));
+  }
+
+  {
+    // The results are loaded from the file, lines with an
+    // invalid checksum or an impossible result are ignored.
+    std::string line1 = "pi 23456789012 0 1000000000";
+    std::string line2 = "pi 13456789012 0 100000000";
+    std::string line3 = "pi 14567890123 0 50000000000";
+    std::ofstream file(path);
+    file << std::hex << std::setfill('0');
+    file << line1 << ' ' << std::setw(16) << result_cache_checksum(line1) << '\n';
+    file << line2 << ' ' << std::setw(16) << result_cache_checksum(line2) + 1 << '\n';
+    file << line3 << ' ' << std::setw(16) << result_cache_checksum(line3) << '\n';
+#ifdef HAVE_INT128_T
+    std::string line4 = "pi 20000000000000000000 0 1000000000";
+    file << line4 << ' ' << std::setw(16) << result_cache_checksum(line4) << '\n';
+#endif
+    file << "pi 5678901234";
+    file.close();
+
+    set_result_cache_file(path);
+    int64_t res = pi((int64_t) 23456789012ll);
+    std::cout << "pi(23456789012) from result cache file = " << res;
+    check(res == 1000000000ll);
+
+    // All pi(x) overloads use the result cache
+    std::string str = pi(std::string("23456789012"), 2);
+    std::cout << "pi(\"23456789012\", 2) from result cache file = " << str;
+    check(str == "1000000000");
+
+#ifdef HAVE_INT128_T
+    int128_t res128 = pi((int128_t) 23456789012ll);
+    std::cout << "pi((int128_t) 23456789012) from result cache file = " << (int64_t) res128;
+    check(res128 == 1000000000);
+
+    str = pi(std::string("20000000000000000000"), 2);
+    std::cout << "pi(\"20000000000000000000\", 2) from result cache file = " << str;
+    check(str == "1000000000");
+
+    int128_t x128 = (int128_t) 20000000000ll * 1000000000;
+    res128 = pi(x128);
+    std::cout << "pi((int128_t) 20000000000000000000) from result cache file = " << (int64_t) res128;
+    check(res128 == 1000000000);
+#endif
+
+    res = pi((int64_t) 13456789012ll);
+    std::cout << "pi(13456789012) invalid checksum ignored = " << res;
+    check(res != 100000000ll);
+
+    res = pi((int64_t) 14567890123ll);
+    std::cout << "pi(14567890123) > x ignored = " << res;
+    check(res != 50000000000ll);
+
+    // Results are appended to the file
+    std::string res2 = pi("34567890123");
+    std::ifstream in(path);
+    std::string content((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+    std::cout << "pi(34567890123) appended to result cache file";
+    check(content.find("pi 34567890123 0 " + res2 + " ") != std::string::npos);
+
+    set_result_cache_file("");
+    set_result_cache_size(0);
+    std::remove(path.c_str());
+  }
+
+  {
+    // Result cache disabled
+    int64_t res = pi((int64_t) 23456789012ll);
+    std::cout << "pi(23456789012) = " << res;
+    check(res != 1000000000000ll);
+  }
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,39 @@
+# Runs "primecount --serve" with the requests from
+# serve_requests.txt and compares the result lines
+# with the expected results from serve_results.txt.
+# Afterwards checks that "primecount --serve=PATH"
+# refuses to delete a file that is not a socket.
+
+execute_process(COMMAND ${PRIMECOUNT} --serve
+                INPUT_FILE ${REQUESTS}
+                OUTPUT_VARIABLE output
+                RESULT_VARIABLE result)
+
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "primecount --serve failed: ${result}")
+endif()
+
+file(READ ${RESULTS} expected)
+
+if(NOT output STREQUAL expected)
+    message(FATAL_ERROR "Expected:\n${expected}\nGot:\n${output}")
+endif()
+
+if(UNIX)
+    set(path ${WORK_DIR}/serve_not_a_socket.txt)
+    file(WRITE ${path} "keep me")
+
+    execute_process(COMMAND ${PRIMECOUNT} --serve=${path}
+                    OUTPUT_QUIET
+                    ERROR_VARIABLE error
+                    RESULT_VARIABLE result)
+
+    file(READ ${path} content)
+    file(REMOVE ${path})
+
+    if(result EQUAL 0 OR NOT content STREQUAL "keep me")
+        message(FATAL_ERROR "primecount --serve=${path} must not delete a regular file: ${error}")
+    endif()
+endif()
+
+message(STATUS "All tests passed successfully!")
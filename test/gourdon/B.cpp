@@ -9,7 +9,9 @@
 ///
 
 #include <primecount.hpp>
+#include <primecount-internal.hpp>
 #include <gourdon.hpp>
+#include <AsyncContext.hpp>
 
 #include <stdint.h>
 #include <iostream>
@@ -99,6 +101,30 @@ int main()
     #endif
   }
 
+  {
+    // Cancel an asynchronous computation during B(x, y).
+    // B_thread() computes pi(x / prime) inside of B's
+    // OpenMP parallel region, this nested computation
+    // must not see the cancelled AsyncContext.
+    int64_t x = 123456789012345678ll;
+    auto alpha = get_alpha_gourdon(x);
+    int64_t y = get_yz_gourdon(x, alpha.first, alpha.second).first;
+    AsyncContext context;
+    context.set_callback([&](double) { context.cancel(); });
+    bool error = false;
+
+    try {
+      AsyncContextGuard guard(&context);
+      B(x, y, 1);
+    }
+    catch (std::exception&) {
+      error = true;
+    }
+
+    std::cout << "B(" << x << ", " << y << ") cancelled = " << context.is_cancelled();
+    check(context.is_cancelled() && !error);
+  }
+
   std::cout << std::endl;
   std::cout << "All tests passed successfully!" << std::endl;
 
@@ -11,6 +11,7 @@
 #include <primecount.hpp>
 #include <primecount-internal.hpp>
 #include <PiTable.hpp>
+#include <primesieve.hpp>
 
 #include <stdint.h>
 #include <iostream>
@@ -41,12 +42,27 @@ int main()
     check(res == 0);
   }
 
+#ifdef HAVE_INT128_T
+  {
+    int128_t x = -1;
+    int128_t res = pi_lmo_parallel_128(x, threads);
+    std::cout << "pi_lmo_parallel_128(" << x << ") = " << res;
+    check(res == 0);
+  }
+#endif
+
   for (int64_t x = 0; x <= PiTable::max_cached(); x++)
   {
     int64_t res1 = pi_lmo_parallel(x, threads);
     int64_t res2 = pi_cache(x);
     std::cout << "pi_lmo_parallel(" << x << ") = " << res1;
     check(res1 == res2);
+
+    #ifdef HAVE_INT128_T
+      int128_t res3 = pi_lmo_parallel_128(x, threads);
+      std::cout << "pi_lmo_parallel_128(" << x << ") = " << res3;
+      check(res3 == res2);
+    #endif
   }
 
   for (int i = 0; i < 1000; i++)
@@ -56,6 +72,12 @@ int main()
     int64_t res2 = pi_meissel(x, threads);
     std::cout << "pi_lmo_parallel(" << x << ") = " << res1;
     check(res1 == res2);
+
+    #ifdef HAVE_INT128_T
+      int128_t res3 = pi_lmo_parallel_128(x, threads);
+      std::cout << "pi_lmo_parallel_128(" << x << ") = " << res3;
+      check(res3 == res2);
+    #endif
   }
 
   {
@@ -66,6 +88,45 @@ int main()
     check(res == 4118054813ll);
   }
 
+#ifdef HAVE_INT128_T
+  {
+    // Test 128-bit computation: pi(1e13)
+    int128_t x = 10000000000000ll;
+    int128_t res = pi_lmo_parallel_128(x, threads);
+    std::cout << "pi_lmo_parallel_128(" << x << ") = " << res;
+    check(res == 346065536839ll);
+  }
+
+  for (int i = 0; i < 100; i++)
+  {
+    // Force using FactorTable<uint32_t>
+    int64_t x = dist(gen);
+    int128_t res1 = pi_lmo_parallel_128(x, threads, false, true);
+    int64_t res2 = pi_meissel(x, threads);
+    std::cout << "pi_lmo_parallel_128(" << x << ", FactorTable<uint32_t>) = " << res1;
+    check(res1 == res2);
+  }
+
+  {
+    // Force using FactorTable<uint32_t>: pi(1e13)
+    int128_t x = 10000000000000ll;
+    int128_t res = pi_lmo_parallel_128(x, threads, false, true);
+    std::cout << "pi_lmo_parallel_128(" << x << ", FactorTable<uint32_t>) = " << res;
+    check(res == 346065536839ll);
+  }
+
+  {
+    // Largest 128-bit test that runs in about 1 second,
+    // pi_lmo_parallel_128(x) for x > 2^63 takes about an
+    // hour on a single CPU core.
+    int64_t x = 100000000000000ll + dist(gen);
+    int128_t res1 = pi_lmo_parallel_128(x, threads);
+    int64_t res2 = 3204941750802ll + primesieve::count_primes(100000000000001ll, x);
+    std::cout << "pi_lmo_parallel_128(" << x << ") = " << res1;
+    check(res1 == res2);
+  }
+#endif
+
   std::cout << std::endl;
   std::cout << "All tests passed successfully!" << std::endl;
 
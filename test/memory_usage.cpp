@@ -0,0 +1,191 @@
+///
+/// @file   memory_usage.cpp
+/// @brief  Test the memory usage model and the --max-memory
+///         option which decreases the alpha tuning factors.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primecount.hpp>
+#include <primecount-internal.hpp>
+#include <gourdon.hpp>
+#include <Numa.hpp>
+#include <imath.hpp>
+
+#include <stdint.h>
+#include <iostream>
+#include <cstdlib>
+#include <random>
+
+using namespace primecount;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  int threads = get_num_threads();
+
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  std::uniform_int_distribution<int64_t> dist(1000000000, 100000000000ll);
+
+  {
+    // Memory usage grows with x
+    int64_t x1 = (int64_t) 1e15;
+    int64_t x2 = (int64_t) 1e18;
+    int64_t y1 = iroot<3>(x1) * 10;
+    int64_t y2 = iroot<3>(x2) * 10;
+    double mem1 = memory_usage_gourdon(x1, y1, y1 * 2, 1);
+    double mem2 = memory_usage_gourdon(x2, y2, y2 * 2, 1);
+    std::cout << "memory_usage_gourdon(" << x1 << ") < memory_usage_gourdon(" << x2 << ")";
+    check(mem1 < mem2);
+
+    mem1 = memory_usage_deleglise_rivat(x1, y1, 1);
+    mem2 = memory_usage_deleglise_rivat(x2, y2, 1);
+    std::cout << "memory_usage_deleglise_rivat(" << x1 << ") < memory_usage_deleglise_rivat(" << x2 << ")";
+    check(mem1 < mem2);
+  }
+
+#if defined(HAVE_INT128_T)
+  {
+    // For z > FactorTableD<uint16_t>::max() D(x, y) uses
+    // FactorTableD<uint32_t> by default and the bit-packed
+    // CompactFactorTableD only if --max-memory requires it.
+    int128_t x = ipow<27>((int128_t) 10);
+    int64_t y = iroot<3>(x) * 10;
+    int64_t z = y * 2;
+    double mem1 = memory_usage_gourdon(x, y, z, 1, false);
+    double mem2 = memory_usage_gourdon(x, y, z, 1, true);
+    std::cout << "memory_usage_gourdon(1e27) = " << mem1 << ", compact = " << mem2;
+    check(mem2 < mem1 * 0.75);
+  }
+#endif
+
+  {
+    // Memory usage grows with the number of threads
+    int64_t x = (int64_t) 1e18;
+    int64_t y = iroot<3>(x) * 10;
+    double mem1 = memory_usage_gourdon(x, y, y * 2, 1);
+    double mem2 = memory_usage_gourdon(x, y, y * 2, 64);
+    std::cout << "memory_usage_gourdon(threads=1) < memory_usage_gourdon(threads=64)";
+    check(mem1 < mem2);
+  }
+
+  {
+    // NUMA_REPLICATE uses one copy of the
+    // lookup tables per NUMA node.
+    int64_t x = (int64_t) 1e18;
+    int64_t y = iroot<3>(x) * 10;
+    double mem1 = memory_usage_gourdon(x, y, y * 2, 1);
+    set_numa_policy(NUMA_REPLICATE);
+    double mem2 = memory_usage_gourdon(x, y, y * 2, 1);
+    set_numa_policy(NUMA_DEFAULT);
+    std::cout << "memory_usage_gourdon(numa=replicate, " << numa_nodes() << " nodes) = " << mem2;
+    check((numa_nodes() == 1) ? mem1 == mem2 : mem1 < mem2);
+  }
+
+  {
+    // --max-memory decreases alpha_y and alpha_z
+    int64_t x = (int64_t) 1e18;
+    auto alpha1 = get_alpha_gourdon(x);
+    set_max_memory(1 << 20);
+    auto alpha2 = get_alpha_gourdon(x);
+    std::cout << "alpha_y * alpha_z with --max-memory=1M: " << alpha2.first * alpha2.second;
+    check(alpha2.first * alpha2.second < alpha1.first * alpha1.second);
+
+    double alpha3 = get_alpha_deleglise_rivat(x);
+    set_max_memory(-1);
+    double alpha4 = get_alpha_deleglise_rivat(x);
+    std::cout << "alpha with --max-memory=1M: " << alpha3;
+    check(alpha3 < alpha4);
+  }
+
+  // pi(x) must not be affected by --max-memory
+  set_max_memory(1 << 22);
+
+  for (int i = 0; i < 20; i++)
+  {
+    int64_t x = dist(gen);
+    int64_t res1 = pi_gourdon_64(x, threads, false);
+    int64_t res2 = pi_meissel(x, threads, false);
+    std::cout << "pi_gourdon_64(" << x << ") with --max-memory=4M = " << res1;
+    check(res1 == res2);
+
+    res1 = pi_deleglise_rivat_64(x, threads, false);
+    std::cout << "pi_deleglise_rivat_64(" << x << ") with --max-memory=4M = " << res1;
+    check(res1 == res2);
+  }
+
+  {
+    // The compact PiTable layout is used if the default
+    // layout exceeds --max-memory. It only depends on
+    // x, y, z, hence nested pi(x) computations (which
+    // call get_alpha_*()) do not change it.
+    int64_t x = (int64_t) 1e15;
+    set_max_memory(-1);
+    auto alpha = get_alpha_gourdon(x);
+    auto yz = get_yz_gourdon(x, alpha.first, alpha.second);
+    int64_t y = yz.first;
+    int64_t z = yz.second;
+    double mem1 = memory_usage_gourdon(x, y, z, 1, false);
+    double mem2 = memory_usage_gourdon(x, y, z, 1, true);
+    std::cout << "memory_usage_gourdon(1e15, compact PiTable) = " << mem2;
+    check(mem2 < mem1);
+
+    std::cout << "No --max-memory, compact PiTable = " << is_compact_pi_table_gourdon(x, y, z, 1);
+    check(!is_compact_pi_table_gourdon(x, y, z, 1));
+
+    set_max_memory((mem1 + mem2) / 2);
+    get_alpha_gourdon(isqrt(x));
+    std::cout << "--max-memory between both layouts, compact PiTable = " << is_compact_pi_table_gourdon(x, y, z, 1);
+    check(is_compact_pi_table_gourdon(x, y, z, 1));
+    set_max_memory(-1);
+
+    y = (int64_t)(iroot<3>(x) * get_alpha_deleglise_rivat(x));
+    mem1 = memory_usage_deleglise_rivat(x, y, 1, false);
+    mem2 = memory_usage_deleglise_rivat(x, y, 1, true);
+    set_max_memory((mem1 + mem2) / 2);
+    get_alpha_deleglise_rivat(isqrt(x));
+    std::cout << "memory_usage_deleglise_rivat(1e15) with --max-memory between both layouts, compact PiTable = " << is_compact_pi_table_deleglise_rivat(x, y, 1);
+    check(mem2 < mem1 && is_compact_pi_table_deleglise_rivat(x, y, 1));
+
+    int64_t res1 = pi_gourdon_64(x, 1, false);
+    int64_t res2 = pi_deleglise_rivat_64(x, 1, false);
+    std::cout << "pi(1e15) using the compact PiTable = " << res1;
+    check(res1 == 29844570422669ll && res2 == res1);
+    set_max_memory(-1);
+  }
+
+  {
+    // Too small memory limit
+    set_max_memory(1024);
+
+    try
+    {
+      int64_t x = (int64_t) 1e15;
+      pi_gourdon_64(x, threads, false);
+      std::cout << "pi_gourdon_64(1e15) with --max-memory=1K";
+      check(false);
+    }
+    catch (primecount_error& e)
+    {
+      std::cout << "pi_gourdon_64(1e15) with --max-memory=1K: " << e.what();
+      check(true);
+    }
+
+    set_max_memory(-1);
+  }
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,155 @@
+///
+/// @file   pi_anchor.cpp
+/// @brief  Test the pi_anchor(x) function which computes pi(x)
+///         using a known pi(anchor) value if x is close to
+///         an anchor.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primecount.hpp>
+#include <primecount-internal.hpp>
+#include <gourdon.hpp>
+#include <int128_t.hpp>
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cmath>
+#include <iostream>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace primecount;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  int threads = get_num_threads();
+
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  std::uniform_int_distribution<int64_t> dist(-1000000, 1000000);
+
+  // Recompute all anchors <= 10^16 using Xavier Gourdon's
+  // algorithm, larger anchors take minutes to recompute.
+  for (auto anchor : get_pi_anchors())
+  {
+    if (anchor.first > (int64_t) 1e16)
+      break;
+
+    int64_t x = (int64_t) anchor.first;
+    int64_t res1 = pi_anchor(x, threads, false);
+    int64_t res2 = pi_gourdon_64(x, threads, false);
+    std::cout << "pi_anchor(" << x << ") = " << res1;
+    check(res1 == res2 && res1 == anchor.second);
+  }
+
+  // Check that all anchors satisfy Schoenfeld's bound
+  // |pi(x) - li(x)| < sqrt(x) * log(x) / (8 * pi)
+  // for x >= 2657, which holds if the Riemann hypothesis
+  // is true. This catches typos in the large anchors.
+  for (auto anchor : get_pi_anchors())
+  {
+    maxint_t x = anchor.first;
+    maxint_t pix = anchor.second;
+    maxint_t diff = pix - Li(x);
+    double dist = (double) (diff < 0 ? -diff : diff);
+    double max_dist = std::sqrt((double) x) * std::log((double) x) / (8 * 3.141592653589793);
+    std::cout << "Schoenfeld bound pi(" << x << ") = " << pix;
+    check(x < 2657 || dist < max_dist);
+  }
+
+  // Anchors <= 10^13
+  int64_t anchors[] = { 1000000000, 4294967296ll, 10000000000ll,
+                        100000000000ll, 1000000000000ll,
+                        10000000000000ll, 29996224275833ll };
+
+  // x close to an anchor
+  for (int64_t x : anchors)
+  {
+    for (int i = 0; i < 5; i++)
+    {
+      int64_t y = x + dist(gen);
+      int64_t res1 = pi_anchor(y, threads, false);
+      int64_t res2 = pi_gourdon_64(y, threads, false);
+      std::cout << "pi_anchor(" << y << ") = " << res1;
+      check(res1 == res2);
+    }
+  }
+
+  {
+    // x far away from all anchors
+    int64_t x = (int64_t) 5e12;
+    int64_t res = pi_anchor(x, threads, false);
+    std::cout << "pi_anchor(" << x << ") = " << res;
+    check(res == -1);
+  }
+
+  {
+    // 10^18 - 11 is the largest prime < 10^18
+    int64_t x = (int64_t) 1e18 - 11;
+    int64_t res1 = pi_anchor(x - 1, threads, false);
+    int64_t res2 = pi_anchor(x, threads, false);
+    std::cout << "pi_anchor(" << x << ") = " << res2;
+    check(res2 == 24739954287740860ll && res1 == res2 - 1);
+  }
+
+  {
+    // Concurrent single-threaded pi_anchor(x) calls, like
+    // pi(x / prime) in B(x, y), must restore primesieve's
+    // number of threads.
+    int primesieve_threads = primesieve::get_num_threads();
+    int64_t x = (int64_t) 1e12;
+    std::vector<int64_t> res(4);
+    std::vector<std::thread> workers;
+
+    for (int i = 0; i < 4; i++)
+      workers.emplace_back([&, i]() { res[i] = pi_anchor(x + i * 1000, 1, false); });
+    for (auto& worker : workers)
+      worker.join();
+
+    for (int i = 0; i < 4; i++)
+    {
+      std::cout << "pi_anchor(" << x + i * 1000 << ") = " << res[i];
+      check(res[i] == pi_gourdon_64(x + i * 1000, threads, false));
+    }
+
+    std::cout << "primesieve::get_num_threads() = " << primesieve::get_num_threads();
+    check(primesieve::get_num_threads() == primesieve_threads);
+  }
+
+#ifdef HAVE_INT128_T
+  {
+    // 2^64 - 59 is the largest prime < 2^64
+    int128_t x = ((int128_t) 1 << 64) - 59;
+    int128_t res1 = pi_anchor(x - 1, threads, false);
+    int128_t res2 = pi_anchor(x, threads, false);
+    std::cout << "pi_anchor(" << x << ") = " << res2;
+    check(res2 == 425656284035217743ll && res1 == res2 - 1);
+
+    // 2^64 + 13 is the smallest prime > 2^64
+    x = ((int128_t) 1 << 64) + 13;
+    res1 = pi_anchor(x - 1, threads, false);
+    res2 = pi_anchor(x, threads, false);
+    std::cout << "pi_anchor(" << x << ") = " << res2;
+    check(res1 == 425656284035217743ll && res2 == res1 + 1);
+
+  }
+#endif
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
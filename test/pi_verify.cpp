@@ -0,0 +1,126 @@
+///
+/// @file   pi_verify.cpp
+/// @brief  Test pi_verify_64(x) and pi_verify_128(x) which
+///         compute pi(x) using both Xavier Gourdon's algorithm
+///         and the Deleglise-Rivat algorithm.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primecount.hpp>
+#include <primecount-internal.hpp>
+#include <PiTable.hpp>
+#include <PhiTiny.hpp>
+#include <pi_verify.hpp>
+
+#include <stdint.h>
+#include <iostream>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+using namespace primecount;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  int threads = get_num_threads();
+
+  // Test small x
+  for (int64_t x = 0; x <= PiTable::max_cached(); x++)
+  {
+    int64_t res1 = pi_cache(x);
+    int64_t res2 = pi_verify_64(x, threads);
+    std::cout << "pi_verify_64(" << x << ") = " << res2;
+    check(res2 == res1);
+  }
+
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  std::uniform_int_distribution<int64_t> dist(0, 1 << 27);
+
+  // Test medium x
+  for (int i = 0; i < 300; i++)
+  {
+    int64_t x = dist(gen);
+    int64_t res1 = pi_meissel(x, threads);
+    int64_t res2 = pi_verify_64(x, threads);
+    std::cout << "pi_verify_64(" << x << ") = " << res2;
+    check(res2 == res1);
+
+    #ifdef HAVE_INT128_T
+      int128_t res3 = pi_verify_128(x, threads);
+      std::cout << "pi_verify_128(" << x << ") = " << res3;
+      check(res3 == res1);
+    #endif
+  }
+
+  {
+    // Test larger computation: pi(1e11)
+    int64_t x = 100000000000ll;
+    int64_t res = pi_verify_64(x, threads);
+    std::cout << "pi_verify_64(" << x << ") = " << res;
+    check(res == 4118054813ll);
+  }
+
+#ifdef HAVE_INT128_T
+  {
+    // Test larger computation: pi(1e12)
+    int128_t x = 1000000000000ll;
+    int128_t res = pi_verify_128(x, threads);
+    std::cout << "pi_verify_128(" << x << ") = " << res;
+    check(res == 37607912018ll);
+  }
+#endif
+
+  {
+    // Verification failure: find_bad_formulas() recomputes
+    // the formulas and reports the formulas whose results
+    // differ from the (corrupted) first results.
+    int64_t x = 10000000000ll;
+    auto alpha = get_alpha_gourdon(x);
+    auto yz = get_yz_gourdon(x, alpha.first, alpha.second);
+    int64_t y = yz.first;
+    int64_t z = yz.second;
+    int64_t k = PhiTiny::get_k(x);
+    int64_t pi_y = pi(y);
+    int64_t b = B(x, y, threads, false);
+    int64_t p2 = P2(x, y, pi_y, threads, false);
+
+    for (int threads_dr : { 0, 1 })
+    {
+      GourdonFormulas<int64_t> g;
+      DelegliseRivatFormulas<int64_t> dr;
+      compute_formulas(x, y, z, k, pi_y, b, p2, 1, threads_dr, false, g, dr);
+      int64_t pix = g.ac - b + g.d + g.phi0 + g.sigma;
+      std::cout << "compute_formulas(" << x << ", threads_dr = " << threads_dr << ") = " << pix;
+      check(pix == 455052511);
+
+      std::string str = find_bad_formulas(x, y, z, k, pi_y, b, p2, 1, threads_dr, false, g, dr);
+      std::cout << "find_bad_formulas(): reproducible mismatch";
+      check(str.find("reproducible, this is a bug") != std::string::npos);
+
+      g.d += 1;
+      dr.s2_easy -= 1;
+      str = find_bad_formulas(x, y, z, k, pi_y, b, p2, 1, threads_dr, false, g, dr);
+      std::cout << "find_bad_formulas(): D and S2_easy not reproducible";
+      check(str.find("D is not reproducible") != std::string::npos &&
+            str.find("S2_easy is not reproducible") != std::string::npos &&
+            str.find("S2_hard") == std::string::npos);
+    }
+  }
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+///
+/// @file   sieve_cost.cpp
+/// @brief  Test the pi_cost(x) model used by pi(low, high),
+///         nth_prime(n) and pi_anchor(x). The model is fitted
+///         for 10^10 <= x <= 10^19 and clamped outside of this
+///         range, it must be continuous and increasing.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primecount-internal.hpp>
+#include <int128_t.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace primecount;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  std::cout << "pi_cost(1e9) = " << pi_cost((int64_t) 1e9);
+  check(pi_cost((int64_t) 1e9) == pi_cost((int64_t) 1e10));
+
+  std::cout << "pi_cost(1e12) = " << pi_cost((int64_t) 1e12);
+  check(pi_cost((int64_t) 1e12) == 9e7);
+
+  std::cout << "pi_cost(9e18) = " << pi_cost((int64_t) 9e18);
+  check(pi_cost((int64_t) 9e18) == pi_cost((int64_t) 1e18));
+
+  double prev = 0;
+  int64_t x = 1;
+
+  // pi_cost(x) is increasing
+  for (int i = 0; i <= 18; i++, x *= 10)
+  {
+    double cost = pi_cost(x);
+    std::cout << "pi_cost(1e" << i << ") = " << cost;
+    check(cost >= prev);
+    prev = cost;
+  }
+
+#ifdef HAVE_INT128_T
+  // Continuous at 10^19, then grows like pi(x)'s run time
+  int128_t y = (int128_t) 1e19;
+  std::cout << "pi_cost(1e19 + 1e9) = " << pi_cost(y + (int64_t) 1e9);
+  check(std::abs(pi_cost(y + (int64_t) 1e9) / pi_cost(y) - 1) < 1e-6);
+
+  for (int i = 20; i <= 30; i++)
+  {
+    y *= 10;
+    double cost = pi_cost(y);
+    std::cout << "pi_cost(1e" << i << ") = " << cost;
+    check(cost > prev * 4 && cost < prev * 5);
+    prev = cost;
+  }
+#endif
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
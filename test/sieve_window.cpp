@@ -0,0 +1,81 @@
+///
+/// @file   sieve_window.cpp
+/// @brief  Test the SieveWindow class which keeps its sieving
+///         primes between windows. Windows move forward and
+///         backward and the number of primes inside each
+///         window is compared to primesieve::count_primes().
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <sieve_window.hpp>
+#include <int128_t.hpp>
+#include <popcnt.hpp>
+#include <primesieve.hpp>
+#include <Vector.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace primecount;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+#ifdef HAVE_INT128_T
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  std::uniform_int_distribution<int64_t> dist_size(1, 1 << 16);
+  std::uniform_int_distribution<int64_t> dist_jump(-(1 << 22), 1 << 22);
+
+  SieveWindow kept(2, true);
+  Vector<uint64_t> sieve1;
+  Vector<uint64_t> sieve2;
+  uint64_t low = 1000000000001ull;
+
+  for (int i = 0; i < 200; i++)
+  {
+    int64_t size = dist_size(gen);
+    uint64_t high = low + 2 * (size - 1);
+    kept.sieve(low, size, sieve1);
+
+    // Sieve the same window without kept sieving primes
+    SieveWindow window(2, false);
+    window.sieve(low, size, sieve2);
+
+    uint64_t count = 0;
+    bool equal = true;
+
+    for (std::size_t j = 0; j < sieve1.size(); j++)
+    {
+      count += popcnt64(~sieve1[j]);
+      equal &= (sieve1[j] == sieve2[j]);
+    }
+
+    std::cout << "primes inside [" << low << ", " << high << "] = " << count;
+    check(equal && count == primesieve::count_primes(low, high));
+
+    // Consecutive windows, forward and backward jumps
+    if (i % 3 == 0)
+      low = high + 2;
+    else
+      low += 2 * dist_jump(gen);
+  }
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+#endif
+
+  return 0;
+}